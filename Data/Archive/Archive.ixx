@@ -317,7 +317,8 @@ public:
         if (auto size = GetFileSize(fileID))
         {
             result.reset(Pack::PackFile::Alloc(size));
-            GetFile(fileID, { (byte*)result.get(), size });
+            if (auto const read = GetFile(fileID, { (byte*)result.get(), size }); read < size)
+                std::fill_n((byte*)result.get() + read, size - read, 0);
         }
         return result;
     }
@@ -76,6 +76,7 @@ public:
     void Add(Kind kind, std::filesystem::path const& path);
 
     bool IsLoaded() const { return m_loaded; }
+    void WaitUntilLoaded() const { m_loaded.wait(false); }
     void Load(Utils::Async::ProgressBarContext& progress)
     {
         if (m_loaded)
@@ -93,13 +94,14 @@ public:
         }
 
         m_loaded = true;
+        m_loaded.notify_all();
     }
 
 private:
     boost::container::static_vector<Source, 5> m_sources;
     std::set<File> m_files;
     uint32 m_maxFileID = 0;
-    bool m_loaded = false;
+    std::atomic<bool> m_loaded = false;
 };
 
 }
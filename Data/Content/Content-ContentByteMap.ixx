@@ -0,0 +1,56 @@
+export module GW2Viewer.Data.Content:ContentByteMap;
+import GW2Viewer.Common;
+import std;
+
+export namespace GW2Viewer::Data::Content
+{
+
+// Pointer-sized slots of a content file that were fixed up while loading. Only the slots themselves are stored instead of a byte per content byte,
+// everything between them is data that no fixup touched.
+class ContentByteMap
+{
+public:
+    enum class Kinds : byte
+    {
+        None = 0,
+        LocalOffset = 0xAA,
+        String = 0xBB,
+        ExternalOffset = 0xEE,
+        File = 0xFF,
+    };
+    struct Slot
+    {
+        uint32 Offset;
+        Kinds Kind;
+
+        [[nodiscard]] uint32 End() const { return Offset + SlotSize; }
+    };
+    static constexpr uint32 SlotSize = sizeof(void*);
+
+    void Reserve(size_t count) { m_slots.reserve(count); }
+    void Mark(uint32 offset, Kinds kind) { m_slots.emplace_back(offset, kind); }
+    // Has to be called once every slot is marked, fixups come in one list per kind
+    void Finish()
+    {
+        std::ranges::stable_sort(m_slots, std::less(), &Slot::Offset);
+        m_slots.shrink_to_fit();
+    }
+
+    [[nodiscard]] Kinds Get(uint32 offset) const
+    {
+        auto const slots = GetSlots(offset, offset + 1);
+        return slots.empty() ? Kinds::None : slots.back().Kind;
+    }
+    // Slots overlapping [begin, end) in offset order, the gaps between them are the bytes no fixup touched
+    [[nodiscard]] std::span<Slot const> GetSlots(uint32 begin, uint32 end) const
+    {
+        auto const first = std::ranges::upper_bound(m_slots, begin, std::less(), &Slot::End);
+        auto const last = std::ranges::lower_bound(first, m_slots.end(), end, std::less(), &Slot::Offset);
+        return { first, last };
+    }
+
+private:
+    std::vector<Slot> m_slots; // Sorted by offset, never overlapping
+};
+
+}
@@ -13,6 +13,7 @@ struct ContentFilter
 
     ContentTypeInfo const* Type { };
     std::wstring NameSearch;
+    std::vector<bool> NameCandidates; // Empty unless the name index narrowed NameSearch down to these objects, objects it doesn't cover are always candidates
     std::optional<GUID> GUIDSearch;
     std::optional<std::pair<uint32, uint32>> UIDSearch;
     std::optional<std::pair<uint32, uint32>> DataIDSearch;
@@ -7,19 +7,12 @@ import GW2Viewer.Data.Content.Mangling;
 import GW2Viewer.Data.Encryption;
 import GW2Viewer.Tasks.ContentObjectDisplayFormat;
 import GW2Viewer.User.Config;
+import GW2Viewer.Utils.Container;
 import GW2Viewer.Utils.Encoding;
 
 namespace GW2Viewer::Data::Content
 {
 
-void ContentObject::AddReference(ContentObject& target, Reference::Types type)
-{
-    if (Reference reference { &target, type }; !std::ranges::contains(OutgoingReferences, reference))
-        OutgoingReferences.emplace_back(reference);
-    if (Reference reference { this, type }; !std::ranges::contains(target.IncomingReferences, reference))
-        target.IncomingReferences.emplace_back(reference);
-}
-
 void ContentObject::Finalize() const
 {
     if (Data.size() != UNINITIALIZED_SIZE)
@@ -40,8 +33,8 @@ void ContentObject::Finalize() const
     }
     if (Data.size() == UNINITIALIZED_SIZE)
     {
-        auto const itr = std::ranges::upper_bound(*ContentFileEntryBoundaries, ContentFileEntryOffset);
-        assert(itr != ContentFileEntryBoundaries->end());
+        auto const itr = Utils::Container::BranchlessUpperBound(*ContentFileEntryBoundaries, ContentFileEntryOffset);
+        assert(itr != std::to_address(ContentFileEntryBoundaries->end()));
         Data = { Data.data(), Data.data() + (*itr - ContentFileEntryOffset) };
     }
     if (Data.size() == UNINITIALIZED_SIZE)
@@ -75,49 +68,72 @@ std::wstring ContentObject::GetDebugDisplayName() const
     return std::format(L"[{}] {}", Type->GetDisplayName(), GetDisplayName());
 }
 
+std::wstring GetDesignatedName(ContentObject const& object, TypeInfo const& typeInfo, bool skipFormat)
+{
+    if (!skipFormat && !typeInfo.DisplayFormat.empty())
+        if (auto const text = G::Tasks::ContentObjectDisplayFormat.Process(object, typeInfo.DisplayFormat); !text.empty())
+            return Utils::Encoding::FromUTF8(text);
+
+    auto [recursion, guard] = G::Tasks::ContentObjectDisplayFormat.GetRecursionGuard(object);
+    if (recursion)
+    {
+        DisplayNameCache::RecordRecursion(object);
+        return recursion;
+    }
+
+    bool wasEncrypted = false;
+    static auto const encryptedText = GetStatusText(Encryption::Status::Encrypted);
+    std::wstring name;
+    for (auto const& field : typeInfo.NameFields)
+    {
+        CompileSymbolPath(field).ForEach(object, [&](QuerySymbolDataResult const& result)
+        {
+            std::string value;
+            auto const symbolType = result.Symbol.GetType();
+            if (auto text = symbolType->GetDisplayText(result); !text.empty())
+                value = std::move(text);
+            else if (auto const content = symbolType->GetContent(result).value_or(nullptr))
+                value = Utils::Encoding::ToUTF8(content->GetDisplayName(false, true));
+
+            if (value == encryptedText)
+            {
+                wasEncrypted = true;
+                return true;
+            }
+
+            if (!value.empty())
+                name = Utils::Encoding::FromUTF8(wasEncrypted ? encryptedText + value : value);
+            return name.empty();
+        });
+        if (!name.empty())
+            break;
+    }
+    return name;
+}
+
 std::wstring ContentObject::GetDisplayName(bool skipCustom, bool skipColor, bool skipFormat) const
 {
     if (!skipCustom)
     {
         // Use custom name if set
+        DisplayNameCache::RecordCustomName(*this);
         if (auto const custom = GetCustomName(*this))
             return skipColor ? *custom : std::format(L"<c=#{}>{}</c>", IsCustomNameCorrect(*this, *custom) ? L"CFC" : L"FCC", *custom);
 
         // Use name from a designated symbol if enabled and available
         if (auto const& typeInfo = Type->GetTypeInfo(); !typeInfo.DisplayFormat.empty() || !typeInfo.NameFields.empty())
         {
-            if (!skipFormat && !typeInfo.DisplayFormat.empty())
-                if (auto const text = G::Tasks::ContentObjectDisplayFormat.Process(*this, typeInfo.DisplayFormat); !text.empty())
-                    return Utils::Encoding::FromUTF8(text);
-
-            auto [recursion, guard] = G::Tasks::ContentObjectDisplayFormat.GetRecursionGuard(*this);
-            if (recursion)
-                return recursion;
-
-            bool wasEncrypted = false;
-            static auto const encryptedText = GetStatusText(Encryption::Status::Encrypted);
-            for (auto const& field : typeInfo.NameFields)
+            if (skipFormat)
             {
-                for (auto& result : QuerySymbolData(*this, field))
-                {
-                    std::string value;
-                    auto const symbolType = result.Symbol.GetType();
-                    if (auto text = symbolType->GetDisplayText(result); !text.empty())
-                        value = std::move(text);
-                    else if (auto const content = symbolType->GetContent(result).value_or(nullptr))
-                        value = Utils::Encoding::ToUTF8(content->GetDisplayName(false, true));
-
-                    if (value == encryptedText)
-                    {
-                        wasEncrypted = true;
-                        continue;
-                    }
-
-                    if (!value.empty())
-                        return Utils::Encoding::FromUTF8(wasEncrypted ? encryptedText + value : value);
-                }
+                DisplayNameCache::RecordTypeSettings(*Type);
+                if (auto name = GetDesignatedName(*this, typeInfo, true); !name.empty())
+                    return name;
             }
+            else if (auto const entry = DisplayNameCache::Get(*this, [&] { return GetDesignatedName(*this, typeInfo, false); }); !entry->Name.empty())
+                return entry->Name;
         }
+        else
+            DisplayNameCache::RecordTypeSettings(*Type);
     }
     if (auto* name = GetName(); name && name->Name && *name->Name)
         return std::vformat(skipColor ? L"{}" : L"<c=#FFC>{}</c>", std::make_wformat_args(*name->Name));
@@ -156,20 +172,20 @@ std::wstring ContentObject::GetFullName() const
 
 uint32 ContentObject::GetIcon() const
 {
+    uint32 value = 0;
     for (auto const& field : Type->GetTypeInfo().IconFields)
     {
-        for (auto& result : QuerySymbolData(*this, field))
+        CompileSymbolPath(field).ForEach(*this, [&value](QuerySymbolDataResult const& result)
         {
-            uint32 value = 0;
             auto const symbolType = result.Symbol.GetType();
             if (auto const icon = symbolType->GetIcon(result).value_or(0))
                 value = icon;
             else if (auto const content = symbolType->GetContent(result).value_or(nullptr))
                 value = content->GetIcon();
-
-            if (value)
-                return value;
-        }
+            return !value;
+        });
+        if (value)
+            return value;
     }
 
     return { };
@@ -177,20 +193,20 @@ uint32 ContentObject::GetIcon() const
 
 ContentObject const* ContentObject::GetMap() const
 {
+    ContentObject const* value = nullptr;
     for (auto const& field : Type->GetTypeInfo().MapFields)
     {
-        for (auto& result : QuerySymbolData(*this, field))
+        CompileSymbolPath(field).ForEach(*this, [&value](QuerySymbolDataResult const& result)
         {
-            ContentObject const* value = nullptr;
             auto const symbolType = result.Symbol.GetType();
             if (auto const map = symbolType->GetMap(result).value_or(nullptr))
                 value = map;
             else if (auto const content = symbolType->GetContent(result).value_or(nullptr))
                 value = content->GetMap();
-
-            if (value)
-                return value;
-        }
+            return !value;
+        });
+        if (value)
+            return value;
     }
 
     return this;
@@ -213,8 +229,9 @@ bool ContentObject::MatchesFilter(ContentFilter& filter) const
             std::ranges::any_of(Entries, std::bind_back(&ContentObject::MatchesFilter, std::ref(filter))) ||
             (!filter.Type || Type == filter.Type) &&
             (filter.NameSearch.empty()
-                || (name = GetName(), name && name->Name && *name->Name && std::ranges::search(std::wstring_view(*name->Name), filter.NameSearch, std::ranges::equal_to(), std::towupper, std::towupper))
-                || (displayName = GetDisplayName(false, true), std::ranges::search(displayName, filter.NameSearch, std::ranges::equal_to(), std::towupper, std::towupper))) &&
+                || (Index >= filter.NameCandidates.size() || filter.NameCandidates[Index]) && (
+                    (name = GetName(), name && name->Name && *name->Name && std::ranges::search(std::wstring_view(*name->Name), filter.NameSearch, std::ranges::equal_to(), std::towupper, std::towupper))
+                    || (displayName = GetDisplayName(false, true), std::ranges::search(displayName, filter.NameSearch, std::ranges::equal_to(), std::towupper, std::towupper)))) &&
             (!filter.GUIDSearch || (guid = GetGUID(), guid && *guid == *filter.GUIDSearch)) &&
             (!filter.UIDSearch || (id = GetUID(), id && *id >= filter.UIDSearch->first && *id <= filter.UIDSearch->second)) &&
             (!filter.DataIDSearch || (id = GetDataID(), id && *id >= filter.DataIDSearch->first && *id <= filter.DataIDSearch->second));
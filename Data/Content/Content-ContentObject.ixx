@@ -1,5 +1,7 @@
 export module GW2Viewer.Data.Content:ContentObject;
+import :ContentByteMap;
 import :ContentFilter;
+import :DisplayNameCache;
 import :ContentName;
 import :ContentNamespace;
 import :ContentTypeInfo;
@@ -20,7 +22,7 @@ struct ContentObject
     ContentTypeInfo const* Type { };
     ContentNamespace const* Namespace { };
     ContentObject const* Root { };
-    std::vector<ContentObject const*> Entries;
+    std::span<ContentObject const* const> Entries;
     mutable std::span<byte const> Data;
 
     struct Reference
@@ -36,13 +38,15 @@ struct ContentObject
 
         bool operator==(Reference const&) const = default;
     };
-    std::vector<Reference> OutgoingReferences;
-    std::vector<Reference> IncomingReferences;
-    void AddReference(ContentObject& target, Reference::Types type);
+    // Point into arrays owned by the manager, sorted by object index and reference type
+    std::span<Reference const> OutgoingReferences;
+    std::span<Reference const> IncomingReferences;
 
     uint32 const ContentFileEntryOffset;
-    std::set<size_t> const* const ContentFileEntryBoundaries;
-    byte const* ByteMap;
+    std::vector<uint32> const* const ContentFileEntryBoundaries;
+    ContentByteMap const* ByteMap;
+    // Result of the display format or name fields, rebuilt once anything it was built from changes
+    mutable std::atomic<std::shared_ptr<DisplayNameCacheEntry const>> CachedDisplayName;
 
     void Finalize() const;
 
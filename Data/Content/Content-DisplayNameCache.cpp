@@ -0,0 +1,154 @@
+module GW2Viewer.Data.Content;
+import GW2Viewer.Data.Game;
+import GW2Viewer.User.Config;
+import GW2Viewer.Utils.Container;
+import <gsl/util>;
+
+namespace GW2Viewer::Data::Content
+{
+
+struct DisplayNameRecorder
+{
+    ContentObject const* Object;
+    uint32 TextVersion;
+    DisplayNameDependencies Dependencies;
+    bool Uncacheable = false;
+};
+thread_local std::vector<DisplayNameRecorder*> tls_recorders;
+
+uint32 GetTextVersion()
+{
+    return G::Game.Text.GetVersion() + G::Game.Encryption.GetTextKeysVersion();
+}
+size_t GetTypeSettingsHash(uint32 typeIndex)
+{
+    auto const typeInfo = Utils::Container::Find(G::Config.TypeInfo, typeIndex);
+    if (!typeInfo)
+        return 0;
+
+    size_t hash = std::hash<std::string_view>()(typeInfo->Name);
+    auto add = [&hash](std::string_view text) { hash = hash * 31 + std::hash<std::string_view>()(text); };
+    add(typeInfo->DisplayFormat);
+    for (auto const& field : typeInfo->NameFields)
+        add(field);
+    return hash;
+}
+size_t GetCustomNameHash(ContentObject const& object)
+{
+    auto const guid = object.GetGUID();
+    auto const custom = guid ? Utils::Container::Find(G::Config.ContentObjectNames, *guid) : nullptr;
+    return custom ? std::hash<std::wstring>()(*custom) : 0;
+}
+
+void DisplayNameDependencies::Merge(DisplayNameDependencies const& other)
+{
+    if (other.TextLanguage)
+        TextLanguage = other.TextLanguage;
+    if (other.TextVersion)
+        TextVersion = std::min(TextVersion.value_or(*other.TextVersion), *other.TextVersion);
+    LayoutRevision = std::min(LayoutRevision, other.LayoutRevision);
+    TypeSettings.append_range(other.TypeSettings);
+    CustomNames.append_range(other.CustomNames);
+}
+
+DisplayNameCache::Entry DisplayNameCache::Get(ContentObject const& object, std::function<std::wstring()> const& build)
+{
+    auto entry = object.CachedDisplayName.load();
+    if (!entry || !IsCurrent(*entry))
+    {
+        DisplayNameRecorder recorder { &object, GetTextVersion() };
+        recorder.Dependencies.LayoutRevision = GetLayoutRevision();
+        recorder.Dependencies.TypeSettings.emplace_back(object.Type->Index, GetTypeSettingsHash(object.Type->Index));
+        tls_recorders.emplace_back(&recorder);
+        auto name = [&]
+        {
+            auto const _ = gsl::finally([] { tls_recorders.pop_back(); });
+            return build();
+        }();
+
+        Utils::Container::SortAndDeduplicate(recorder.Dependencies.TypeSettings);
+        Utils::Container::SortAndDeduplicate(recorder.Dependencies.CustomNames);
+        entry = std::make_shared<DisplayNameCacheEntry const>(std::move(name), std::move(recorder.Dependencies));
+        if (!recorder.Uncacheable)
+            object.CachedDisplayName.store(entry);
+    }
+    if (!tls_recorders.empty())
+        tls_recorders.back()->Dependencies.Merge(entry->Dependencies);
+    return entry;
+}
+
+bool DisplayNameCache::IsCurrent(DisplayNameCacheEntry const& entry)
+{
+    auto const& dependencies = entry.Dependencies;
+    if (dependencies.TextLanguage && *dependencies.TextLanguage != G::Config.Language)
+        return false;
+    if (dependencies.TextVersion && *dependencies.TextVersion != GetTextVersion())
+        return false;
+    if (dependencies.LayoutRevision != GetLayoutRevision())
+        return false;
+    for (auto const& [typeIndex, hash] : dependencies.TypeSettings)
+        if (GetTypeSettingsHash(typeIndex) != hash)
+            return false;
+    for (auto const& [object, hash] : dependencies.CustomNames)
+        if (GetCustomNameHash(*object) != hash)
+            return false;
+    return true;
+}
+
+void DisplayNameCache::RecordText(Encryption::Status status)
+{
+    if (tls_recorders.empty())
+        return;
+
+    auto& recorder = *tls_recorders.back();
+    recorder.Dependencies.TextLanguage = G::Config.Language;
+    if (status == Encryption::Status::Missing || status == Encryption::Status::Encrypted)
+        recorder.Dependencies.TextVersion = recorder.TextVersion;
+}
+void DisplayNameCache::RecordTypeSettings(ContentTypeInfo const& type)
+{
+    if (!tls_recorders.empty())
+        tls_recorders.back()->Dependencies.TypeSettings.emplace_back(type.Index, GetTypeSettingsHash(type.Index));
+}
+void DisplayNameCache::RecordCustomName(ContentObject const& object)
+{
+    if (!tls_recorders.empty())
+        tls_recorders.back()->Dependencies.CustomNames.emplace_back(&object, GetCustomNameHash(object));
+}
+void DisplayNameCache::RecordRecursion(ContentObject const& object)
+{
+    // Names built between the two occurrences of the object depend on where the recursion started from and can't be reused elsewhere
+    for (auto const recorder : tls_recorders | std::views::reverse)
+    {
+        if (recorder->Object == &object)
+            break;
+        recorder->Uncacheable = true;
+    }
+}
+
+size_t DisplayNameCache::GetStamp()
+{
+    size_t hash = std::hash<uint32>()((uint32)G::Config.Language);
+    auto add = [&hash](size_t value) { hash = hash * 31 + value; };
+    add(GetTextVersion());
+    add(s_customNamesVersion);
+    add(GetLayoutRevision());
+    for (auto const& index : G::Config.TypeInfo | std::views::keys)
+        add(GetTypeSettingsHash(index));
+    return hash;
+}
+
+void DisplayNameCache::RefreshStale(std::span<ContentObject const* const> objects, Utils::Async::ProgressBarContext& progress)
+{
+    std::atomic<size_t> processed = 0;
+    progress.Start("Refreshing content display names", objects.size());
+    std::for_each(std::execution::par, objects.begin(), objects.end(), [&](ContentObject const* object)
+    {
+        if (auto const entry = object->CachedDisplayName.load(); entry && !IsCurrent(*entry))
+            (void)object->GetDisplayName(false, true);
+        if (auto const count = ++processed; !(count % 1024))
+            progress = count;
+    });
+}
+
+}
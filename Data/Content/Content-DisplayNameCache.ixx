@@ -0,0 +1,57 @@
+export module GW2Viewer.Data.Content:DisplayNameCache;
+import GW2Viewer.Common;
+import GW2Viewer.Data.Encryption;
+import GW2Viewer.Utils.Async.ProgressBarContext;
+import std;
+
+export namespace GW2Viewer::Data::Content
+{
+struct ContentObject;
+struct ContentTypeInfo;
+
+// Everything a display name built from display formats and name fields was derived from. Dependencies of the nested display names
+// it contains are merged in, so an entry can be validated without visiting the objects it references.
+struct DisplayNameDependencies
+{
+    std::optional<Language> TextLanguage;   // Set if any string was read
+    std::optional<uint32> TextVersion;      // Set if any string was missing or still encrypted
+    uint32 LayoutRevision = 0;              // Designated names are resolved through the struct layouts
+    std::vector<std::pair<uint32, size_t>> TypeSettings;                // Type index and hash of its display settings
+    std::vector<std::pair<ContentObject const*, size_t>> CustomNames;   // Referenced object and hash of its custom name
+
+    void Merge(DisplayNameDependencies const& other);
+};
+
+struct DisplayNameCacheEntry
+{
+    std::wstring Name; // Empty if none of the designated symbols yielded anything
+    DisplayNameDependencies Dependencies;
+};
+
+class DisplayNameCache
+{
+public:
+    using Entry = std::shared_ptr<DisplayNameCacheEntry const>;
+
+    // Returns the object's cached entry if it's still current, otherwise calls build and caches its result
+    [[nodiscard]] static Entry Get(ContentObject const& object, std::function<std::wstring()> const& build);
+    [[nodiscard]] static bool IsCurrent(DisplayNameCacheEntry const& entry);
+
+    // Record into the entry currently being built on this thread, if there is one
+    static void RecordText(Encryption::Status status);
+    static void RecordTypeSettings(ContentTypeInfo const& type);
+    static void RecordCustomName(ContentObject const& object);
+    static void RecordRecursion(ContentObject const& object);
+
+    static void NotifyCustomNameChanged() { ++s_customNamesVersion; }
+
+    // Changes whenever something that might invalidate cached entries changes
+    [[nodiscard]] static size_t GetStamp();
+    // Rebuilds every cached entry that went stale, so that stale names are rarely rebuilt on the drawing thread
+    static void RefreshStale(std::span<ContentObject const* const> objects, Utils::Async::ProgressBarContext& progress);
+
+private:
+    inline static std::atomic<uint32> s_customNamesVersion = 0;
+};
+
+}
@@ -3,6 +3,8 @@ import :ContentObject;
 import :Symbols;
 import GW2Viewer.Common;
 import GW2Viewer.Data.Game;
+import GW2Viewer.Utils.OrderedOutput;
+import GW2Viewer.Utils.String;
 import std;
 
 namespace GW2Viewer::Data::Content
@@ -236,6 +238,227 @@ QuerySymbolDataResult::Generator QuerySymbolData(ContentObject const& content, T
     for (auto& result : QuerySymbolDataImpl(content, TypeSearcher { content, type, value }))
         co_yield result;
 }
+void ForEachSymbolValue(ContentObject const& content, std::span<TypeInfo::SymbolType const* const> types, std::function<void(uint32 typeIndex, TypeInfo::Condition::ValueType value)> const& callback)
+{
+    struct ValueCollector
+    {
+        ContentObject const& Content;
+        std::span<TypeInfo::SymbolType const* const> Types;
+        std::function<void(uint32 typeIndex, TypeInfo::Condition::ValueType value)> const& Callback;
+        [[nodiscard]] SymbolPath::Part Root() const { return { }; }
+        [[nodiscard]] bool CanSearch() const { return true; }
+        [[nodiscard]] bool CanCheck(TypeInfo::Symbol& symbol) const { return true; }
+        [[nodiscard]] bool CanReturn(TypeInfo::Symbol& symbol, byte const* data) const
+        {
+            for (auto const [index, type] : Types | std::views::enumerate)
+                if (symbol.Type == type->Name)
+                    if (auto const value = type->GetValueForCondition({ data, Content, symbol }))
+                        Callback((uint32)index, *value);
+            return false;
+        }
+        [[nodiscard]] bool CanEarlyReturn() const { return false; }
+        [[nodiscard]] bool CanBacktrack() const { return false; }
+        [[nodiscard]] bool CanBacktrackFrom(byte const* data) const { return false; }
+        [[nodiscard]] bool CanStepIntoNonInlineContent() const { return false; }
+        [[nodiscard]] bool CanSearchDeeper() const { return true; }
+        [[nodiscard]] ValueCollector const& Deeper() const { return *this; }
+        [[nodiscard]] ValueCollector const& Deeper(ContentObject const& relative) const { return Deeper(); }
+    };
+    // Nothing is ever yielded, the whole traversal runs while looking for the first result
+    QuerySymbolDataImpl(content, ValueCollector { content, types, callback }).begin();
+}
+
+static std::atomic<uint32> layoutRevision = 1;
+
+struct CompiledSymbolPath::Step
+{
+    struct Match
+    {
+        uint32 Offset;
+        TypeInfo::Symbol* Symbol;
+        Step const* Element; // Compiled against the symbol's element layout, if the path continues past a non-content symbol
+    };
+    std::vector<Match> Matches;
+};
+struct CompiledSymbolPath::Plans
+{
+    std::shared_mutex Lock;
+    std::map<std::pair<TypeInfo::StructLayout const*, uint32>, std::unique_ptr<Step const>> Steps;
+
+    // Returns nothing for parts that don't need a step, i.e. meta symbols
+    Step const* Get(SymbolPath const& path, TypeInfo::StructLayout& layout, uint32 depth)
+    {
+        if (path.Parts[depth].Type != SymbolPath::Type::String)
+            return nullptr;
+
+        {
+            std::shared_lock _(Lock);
+            if (auto const itr = Steps.find({ &layout, depth }); itr != Steps.end())
+                return itr->second.get();
+        }
+
+        auto step = std::make_unique<Step>();
+        bool const last = depth + 1 == path.Parts.size();
+        for (auto& [offset, symbol] : layout.Symbols)
+            if (symbol.Name == path.Parts[depth].Value.String)
+                step->Matches.emplace_back(offset, &symbol, last || symbol.GetType()->IsContent() ? nullptr : Get(path, symbol.GetElementLayout(), depth + 1));
+
+        std::unique_lock _(Lock);
+        return Steps.try_emplace({ &layout, depth }, std::move(step)).first->second.get();
+    }
+};
+struct CompiledSymbolPath::Evaluator
+{
+    SymbolPath const& Path;
+    Plans& PathPlans;
+    CallbackFunction Callback;
+    void* CallbackContext;
+    TypeInfo::Symbol* Detached;
+    uint32 DetachedOffset;
+    TypeInfo::LayoutStack LayoutStack;
+
+    // Mirrors QuerySymbolDataImpl for string and meta parts, returns false once the callback stopped the query
+    bool Evaluate(std::span<byte const> fullData, uint32 depth, Step const* step)
+    {
+        // Pushing frames can move the stack, so nothing may keep referring to the top frame
+        auto const& content = *LayoutStack.top().Content;
+        auto const dataStart = LayoutStack.top().DataStart;
+        if (depth == Path.Parts.size())
+        {
+            if (Detached->Condition && !Detached->Condition->Field.empty() && !Detached->TestCondition(content, LayoutStack))
+                return true;
+            return Callback(CallbackContext, { &content.Data[dataStart + DetachedOffset], content, *Detached });
+        }
+        if (auto const& part = Path.Parts[depth]; part.Type == SymbolPath::Type::Meta)
+            return Callback(CallbackContext, { &content, content, *part.Value.MetaSymbol });
+
+        bool const last = depth + 1 == Path.Parts.size();
+        for (auto const& [offset, symbol, elementStep] : step->Matches)
+        {
+            if (symbol->Condition && !symbol->Condition->Field.empty() && !symbol->TestCondition(content, LayoutStack))
+                continue;
+
+            byte const* p = &content.Data[dataStart + offset];
+            if (last && !Detached)
+            {
+                if (!Callback(CallbackContext, { p, content, *symbol }))
+                    return false;
+                continue;
+            }
+
+            if (auto const traversal = symbol->GetTraversalInfo({ p, content, *symbol }, true))
+            {
+                if (traversal.Type->IsInline())
+                    if (*traversal.Start < fullData.data() || *traversal.Start >= fullData.data() + fullData.size())
+                        continue;
+
+                auto const elements = std::span(*traversal.Start, traversal.Type->IsInline() ? (size_t)fullData.data() + fullData.size() : std::dynamic_extent) | std::views::stride(traversal.Size) | std::views::take(traversal.ArrayCount.value_or(1));
+                for (auto const& element : elements)
+                {
+                    auto const target = &element;
+                    if (!traversal.Type->IsContent())
+                    {
+                        LayoutStack.emplace(&content, &symbol->GetElementLayout(), std::nullopt, (uint32)std::distance(content.Data.data(), target));
+                        bool const proceed = Evaluate(fullData, depth + 1, elementStep);
+                        LayoutStack.pop();
+                        if (!proceed)
+                            return false;
+                    }
+                    else if (auto const object = G::Game.Content.GetByDataPointer(target))
+                    {
+                        object->Finalize();
+                        auto& layout = object->Type->GetTypeInfo().Layout;
+                        LayoutStack.emplace(object, &layout, std::nullopt, 0);
+                        bool const proceed = Evaluate(traversal.Type->IsInline() ? fullData : object->Data, depth + 1, last ? nullptr : PathPlans.Get(Path, layout, depth + 1));
+                        LayoutStack.pop();
+                        if (!proceed)
+                            return false;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+};
+
+CompiledSymbolPath::CompiledSymbolPath(std::string_view path) : m_source(path), m_path(m_source), m_compiled(std::ranges::none_of(m_path.Parts, [](SymbolPath::Part const& part) { return part.Type == SymbolPath::Type::Reference || part.Type == SymbolPath::Type::Backtrack; }))
+{
+}
+
+std::shared_ptr<CompiledSymbolPath::Plans> CompiledSymbolPath::GetPlans() const
+{
+    auto const revision = GetLayoutRevision();
+    {
+        std::shared_lock _(m_plansLock);
+        if (m_plansRevision == revision)
+            return m_plans;
+    }
+    // Queries still running on the previous plans keep them alive until they finish
+    std::unique_lock _(m_plansLock);
+    if (m_plansRevision != revision)
+    {
+        m_plans = std::make_shared<Plans>();
+        m_plansRevision = revision;
+    }
+    return m_plans;
+}
+
+bool CompiledSymbolPath::ForEachImpl(ContentObject const& content, TypeInfo::Symbol* detached, uint32 detachedOffset, CallbackFunction callback, void* context) const
+{
+    if (m_path.Parts.empty() && !detached)
+        return true;
+
+    if (!m_compiled)
+    {
+        if (detached)
+            return true;
+
+        for (auto& result : QuerySymbolData(content, m_path))
+            if (!callback(context, result))
+                return false;
+        return true;
+    }
+
+    auto const plans = GetPlans();
+    auto& layout = content.Type->GetTypeInfo().Layout;
+    Evaluator evaluator { m_path, *plans, callback, context, detached, detachedOffset };
+    evaluator.LayoutStack.emplace(&content, &layout);
+    auto const step = m_path.Parts.empty() ? nullptr : plans->Get(m_path, layout, 0);
+    if (step && m_path.Parts.size() == 1 && !detached)
+    {
+        // Same as the cheap version in QuerySymbolDataImpl, only the first symbol is returned if no deep traversal is needed
+        for (auto const& [offset, symbol, elementStep] : step->Matches)
+            if (!(symbol->Condition && !symbol->Condition->Field.empty() && !symbol->TestCondition(content, evaluator.LayoutStack)))
+                return callback(context, { &content.Data[offset], content, *symbol });
+        return true;
+    }
+    return evaluator.Evaluate(content.Root ? content.Root->Data : content.Data, 0, step);
+}
+
+CompiledSymbolPath const& CompileSymbolPath(std::string_view path)
+{
+    static std::shared_mutex lock;
+    static std::map<std::string, std::unique_ptr<CompiledSymbolPath const>, std::less<>> paths;
+    {
+        std::shared_lock _(lock);
+        if (auto const itr = paths.find(path); itr != paths.end())
+            return *itr->second;
+    }
+    std::unique_lock _(lock);
+    if (auto const itr = paths.find(path); itr != paths.end())
+        return *itr->second;
+    return *paths.emplace(path, std::make_unique<CompiledSymbolPath const>(path)).first->second;
+}
+
+void NotifyLayoutEdited()
+{
+    ++layoutRevision;
+}
+uint32 GetLayoutRevision()
+{
+    return layoutRevision;
+}
+
 ordered_json ExportSymbolData(ContentObject const& content, ExportOptions const& options)
 {
     static auto const guidSymbol = Symbols::GetByName("GUID");
@@ -300,4 +523,37 @@ ordered_json ExportSymbolData(ContentObject const& content, ExportOptions const&
     return json;
 }
 
+bool ExportSymbolData(std::span<ContentObject const* const> objects, std::ostream& output, ExportOptions const& options, ExportStreamOptions const& streamOptions, std::function<bool(size_t processed)> const& progress)
+{
+    // Elements are dumped on their own and indented by one more level, which produces the same text as dumping the whole array at once
+    bool const pretty = !streamOptions.NDJSON && streamOptions.Indent > 0;
+    std::string const separator = pretty ? "\n" + std::string(streamOptions.Indent, streamOptions.IndentChar) : "";
+
+    bool empty = true;
+    if (!streamOptions.NDJSON)
+        output << '[';
+    bool const completed = Utils::OrderedOutput::ForEachBatch(objects, [&](ContentObject const* object, std::string& buffer)
+    {
+        if (auto const json = ExportSymbolData(*object, options); !json.empty())
+        {
+            buffer = json.dump(pretty ? streamOptions.Indent : -1, streamOptions.IndentChar);
+            if (pretty)
+                Utils::String::ReplaceAll(buffer, "\n", separator);
+        }
+    }, [&](std::string const& buffer)
+    {
+        if (buffer.empty())
+            return;
+        if (streamOptions.NDJSON)
+            output << buffer << '\n';
+        else
+            output << (std::exchange(empty, false) ? "" : ",") << separator << buffer;
+    }, progress);
+    if (!completed)
+        return false;
+    if (!streamOptions.NDJSON)
+        output << (pretty && !empty ? "\n]" : "]") << '\n';
+    return true;
+}
+
 }
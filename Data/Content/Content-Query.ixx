@@ -83,6 +83,58 @@ struct QuerySymbolDataResult : TypeInfo::Context
 QuerySymbolDataResult::Generator QuerySymbolData(ContentObject const& content, SymbolPath::Span path);
 QuerySymbolDataResult::Generator QuerySymbolData(ContentObject const& content, std::string_view path);
 QuerySymbolDataResult::Generator QuerySymbolData(ContentObject const& content, TypeInfo::SymbolType const& type, TypeInfo::Condition::ValueType value);
+// Calls callback with every value that QuerySymbolData(content, *types[typeIndex], value) would find
+void ForEachSymbolValue(ContentObject const& content, std::span<TypeInfo::SymbolType const* const> types, std::function<void(uint32 typeIndex, TypeInfo::Condition::ValueType value)> const& callback);
+
+// Symbol path compiled against the layouts it's evaluated on. Names are resolved to the matching symbols and their offsets once per layout
+// and path depth, and results are passed to a callback instead of being yielded from a generator. Paths that contain @ref or .. parts
+// can't be compiled and are evaluated through QuerySymbolData instead.
+class CompiledSymbolPath
+{
+public:
+    explicit CompiledSymbolPath(std::string_view path);
+    CompiledSymbolPath(CompiledSymbolPath const&) = delete;
+    CompiledSymbolPath& operator=(CompiledSymbolPath const&) = delete;
+
+    [[nodiscard]] std::string_view GetSource() const { return m_source; }
+    [[nodiscard]] bool IsCompiled() const { return m_compiled; }
+
+    // Calls callback with every result until it returns false, returns false if the callback stopped the query
+    template<typename Callback>
+    bool ForEach(ContentObject const& content, Callback&& callback) const
+    {
+        return ForEachImpl(content, nullptr, 0, [](void* context, QuerySymbolDataResult const& result) -> bool { return (*(std::remove_reference_t<Callback>*)context)(result); }, (void*)&callback);
+    }
+    // Same as ForEach, but steps into the element layout of every result and calls callback with symbol at offset in there instead, which lets
+    // symbols that aren't part of any layout be queried, i.e. while they're being defined. An empty path finds symbol at offset of the object itself.
+    // The symbol is tested for its condition like any other, and has to outlive the query. Paths that can't be compiled find nothing.
+    template<typename Callback>
+    bool ForEach(ContentObject const& content, TypeInfo::Symbol& symbol, uint32 offset, Callback&& callback) const
+    {
+        return ForEachImpl(content, &symbol, offset, [](void* context, QuerySymbolDataResult const& result) -> bool { return (*(std::remove_reference_t<Callback>*)context)(result); }, (void*)&callback);
+    }
+
+private:
+    using CallbackFunction = bool(*)(void* context, QuerySymbolDataResult const& result);
+    struct Step;
+    struct Plans;
+    struct Evaluator;
+
+    std::string const m_source;
+    SymbolPath const m_path;
+    bool const m_compiled;
+    mutable std::shared_mutex m_plansLock;
+    mutable std::shared_ptr<Plans> m_plans;
+    mutable uint32 m_plansRevision = 0;
+
+    bool ForEachImpl(ContentObject const& content, TypeInfo::Symbol* detached, uint32 detachedOffset, CallbackFunction callback, void* context) const;
+    [[nodiscard]] std::shared_ptr<Plans> GetPlans() const;
+};
+// Returns a compiled path that lives for the rest of the session
+[[nodiscard]] CompiledSymbolPath const& CompileSymbolPath(std::string_view path);
+// Has to be called whenever struct layouts are edited, drops the plans of every compiled path and outdates everything built from layouts
+void NotifyLayoutEdited();
+[[nodiscard]] uint32 GetLayoutRevision();
 struct ExportOptions
 {
     enum class ContentPointerFormats
@@ -97,4 +149,14 @@ struct ExportOptions
 };
 ordered_json ExportSymbolData(ContentObject const& content, ExportOptions const& options = { });
 
+struct ExportStreamOptions
+{
+    int Indent = -1; // Compact unless positive, same as std::setw when streaming a json
+    char IndentChar = ' ';
+    bool NDJSON = false; // One compact object per line instead of a single array
+};
+// Serializes the objects in parallel batches and writes them in order, so only one batch of serialized objects is held in memory at a time.
+// Objects that export to nothing are skipped. progress is called with the number of processed objects after every batch, returning false stops the export.
+bool ExportSymbolData(std::span<ContentObject const* const> objects, std::ostream& output, ExportOptions const& options, ExportStreamOptions const& streamOptions, std::function<bool(size_t processed)> const& progress);
+
 }
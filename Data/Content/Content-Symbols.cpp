@@ -20,7 +20,9 @@ namespace GW2Viewer::Data::Content::Symbols
 
 TypeInfo::SymbolType const* GetByName(std::string_view name)
 {
-    return *std::ranges::find_if(GetTypes(), [name](auto* type) { return type->Name == name; });
+    // Looked up by every symbol during traversal, the set of types never changes after startup
+    static std::unordered_map<std::string_view, TypeInfo::SymbolType const*> const types { std::from_range, GetTypes() | std::views::transform([](auto* type) { return std::pair<std::string_view, TypeInfo::SymbolType const*> { type->Name, type }; }) };
+    return types.at(name);
 }
 
 template<typename T> std::string Integer<T>::GetDisplayText(Context const& context) const
@@ -325,6 +327,7 @@ std::string StringID::GetDisplayText(Context const& context) const
 {
     auto const stringID = GetStringID(context);
     auto [string, status] = G::Game.Text.Get(stringID);
+    DisplayNameCache::RecordText(status);
     return std::format("{}{}", Encryption::GetStatusText(status), string ? *string : L"");
 }
 ordered_json StringID::Export(Context const& context, ExportOptions const& options) const
@@ -55,6 +55,10 @@ std::optional<TypeInfo::Condition::ValueType> TypeInfo::Symbol::GetValueForCondi
     */
 
     auto const& top = layoutStack.top();
+    if (auto const compiled = top.Layout->GetCompiledCondition(*this))
+        return compiled->Type ? compiled->Type->GetValueForCondition({ &top.Content->Data[top.DataStart + compiled->Offset], *top.Content, *this }) : std::nullopt;
+
+    // Symbol isn't part of the layout yet, i.e. while it's being defined
     if (auto const itr = std::ranges::find_if(top.Layout->Symbols, [field = /*parts.back()*/Condition->Field](auto const& pair) { return pair.second.Name == field; }); itr != top.Layout->Symbols.end())
         if (auto const value = itr->second.GetType()->GetValueForCondition({ &top.Content->Data[top.DataStart + itr->first], *top.Content, *this }))
             return value;
@@ -66,6 +70,15 @@ bool TypeInfo::Symbol::TestCondition(ContentObject const& content, LayoutStack c
     if (!Condition || Condition->Field.empty())
         return true;
 
+    auto const& top = layoutStack.top();
+    if (auto const compiled = top.Layout->GetCompiledCondition(*this))
+    {
+        if (!compiled->Type)
+            return false;
+        auto const value = compiled->Type->GetValueForCondition({ &top.Content->Data[top.DataStart + compiled->Offset], *top.Content, *this });
+        return value && compiled->Test(*value, compiled->Value);
+    }
+
     if (auto const value = GetValueForCondition(content, layoutStack))
         return Condition->Test(*value);
 
@@ -73,6 +86,9 @@ bool TypeInfo::Symbol::TestCondition(ContentObject const& content, LayoutStack c
 }
 void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layoutStack, std::string_view parentPath, bool create, std::string const& placeholderName)
 {
+    // Any of the options below can change how paths resolve, so edits are reported once the options are drawn
+    bool edited = false;
+
     // Name
     auto const oldFullPath = GetFullPath(parentPath);
     bool nameChanged = I::InputTextWithHint("Name", placeholderName.c_str(), &Name);
@@ -96,10 +112,11 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
         std::ranges::for_each(typeInfo.IconFields, fixField);
         std::ranges::for_each(typeInfo.MapFields, fixField);
     }
+    edited |= nameChanged;
 
     // Type
     {
-        UI::Controls::FilteredComboBox("Type", Type, Symbols::GetTypes() | std::views::filter(&SymbolType::IsVisible) | std::views::transform(&SymbolType::Name));
+        edited |= UI::Controls::FilteredComboBox("Type", Type, Symbols::GetTypes() | std::views::filter(&SymbolType::IsVisible) | std::views::transform(&SymbolType::Name));
     }
 
     // ElementTypeName
@@ -108,6 +125,7 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
             ElementTypeShared = !ElementTypeName.empty() && G::Config.SharedTypes.contains(ElementTypeName);
         if (I::Checkbox("Shared", &*ElementTypeShared) && !ElementTypeName.empty())
         {
+            edited = true;
             if (*ElementTypeShared && !G::Config.SharedTypes.contains(ElementTypeName))
                 G::Config.SharedTypes.emplace(ElementTypeName, std::exchange(ElementLayout, StructLayout()));
             else if (G::Config.SharedTypes.contains(ElementTypeName))
@@ -120,14 +138,14 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                 scoped::Combo("ElementTypeName", items(ElementTypeName.empty() ? -1 : std::distance(G::Config.SharedTypes.begin(), G::Config.SharedTypes.find(ElementTypeName))), ImGuiComboFlags_HeightLarge))
             {
                 if (I::ComboItem(items(-1), ElementTypeName.empty()))
-                    ElementTypeName.clear();
+                    ElementTypeName.clear(), edited = true;
                 for (auto const& [index, value] : G::Config.SharedTypes | std::views::keys | std::views::enumerate)
                     if (I::ComboItem(items(index), ElementTypeName == value))
-                        ElementTypeName = value;
+                        ElementTypeName = value, edited = true;
             }
         }
         else
-            I::InputText("ElementTypeName", &ElementTypeName);
+            edited |= I::InputText("ElementTypeName", &ElementTypeName);
     }
 
     // Alignment
@@ -138,13 +156,13 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
             scoped::Combo("Alignment", items(Alignment), ImGuiComboFlags_HeightLarge))
             for (auto const alignment : options)
                 if (I::ComboItem(items(alignment), Alignment == alignment))
-                    Alignment = alignment;
+                    Alignment = alignment, edited = true;
     }
 
     std::vector<std::tuple<char const*, char const*, std::function<void()>>> extraSettings;
     auto booleanToggle = [&](bool& enabled, char const* icon, char const* name, char const* tooltip = nullptr, std::function<void()>&& settings = nullptr)
     {
-        I::CheckboxButton(icon, enabled, tooltip ? tooltip : name, { I::GetFrameHeight(), I::GetFrameHeight() });
+        edited |= I::CheckboxButton(icon, enabled, tooltip ? tooltip : name, { I::GetFrameHeight(), I::GetFrameHeight() });
         I::SameLine(0, 0);
         if (settings && enabled)
             extraSettings.emplace_back(icon, name, std::move(settings));
@@ -154,6 +172,7 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
         bool enabled = optional.has_value();
         if (I::CheckboxButton(icon, enabled, tooltip ? tooltip : name, { I::GetFrameHeight(), I::GetFrameHeight() }))
         {
+            edited = true;
             if (enabled)
                 optional.emplace();
             else
@@ -169,6 +188,7 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
         if (scoped::Disabled(Name.empty()))
         if (I::CheckboxButton(icon, enabled, tooltip ? tooltip : name, { I::GetFrameHeight(), I::GetFrameHeight() }))
         {
+            edited = true;
             if (enabled)
                 pathList.emplace_back(fullPath);
             else
@@ -191,7 +211,7 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                     int const dragging = I::GetMousePos().y < rect.Min.y ? -1 : I::GetMousePos().y >= rect.Max.y ? 1 : 0;
                     if (I::IsItemActive() && !I::IsItemHovered() && dragging)
                         if (int const next = index + dragging; next >= 0 && next < pathList.size())
-                            std::swap(pathList[index], pathList[next]);
+                            std::swap(pathList[index], pathList[next]), edited = true;
                 }
             });
         }
@@ -226,10 +246,10 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
         auto const itr = std::ranges::find(fields, Condition->Field);
         int index = itr != fields.end() ? std::distance(fields.begin(), itr) : -1;
         if (I::Combo("Field", &index, [](void* fields, int index) { return (*(std::vector<std::string>*)fields)[index].c_str(); }, &fields, fields.size()) && index >= 0)
-            Condition->Field = fields[index];
+            Condition->Field = fields[index], edited = true;
 
-        I::Combo("Comparison", (int*)&Condition->Comparison, Condition::IMGUI_COMPARISONS);
-        I::InputScalar("Value", ImGuiDataType_S64, &Condition->Value);
+        edited |= I::Combo("Comparison", (int*)&Condition->Comparison, Condition::IMGUI_COMPARISONS);
+        edited |= I::InputScalar("Value", ImGuiDataType_S64, &Condition->Value);
     });
     optionalToggle(Enum, ICON_FA_LIST_OL, "Enum", "Display as Enum", [&]
     {
@@ -238,6 +258,7 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                 EnumShared = !Enum->Name.empty() && G::Config.SharedEnums.contains(Enum->Name);
             if (I::Checkbox("Shared", &*EnumShared) && !Enum->Name.empty())
             {
+                edited = true;
                 if (*EnumShared && !G::Config.SharedEnums.contains(Enum->Name))
                     G::Config.SharedEnums.emplace(Enum->Name, std::exchange(*Enum, TypeInfo::Enum { .Name = Enum->Name }));
                 else
@@ -254,19 +275,19 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                     scoped::Combo("##Name", items(Enum->Name.empty() ? -1 : std::distance(G::Config.SharedEnums.begin(), G::Config.SharedEnums.find(Enum->Name))), ImGuiComboFlags_HeightLarge))
                 {
                     if (I::ComboItem(items(-1), Enum->Name.empty()))
-                        Enum->Name.clear();
+                        Enum->Name.clear(), edited = true;
                     for (auto const& [index, value] : G::Config.SharedEnums | std::views::keys | std::views::enumerate)
                         if (I::ComboItem(items(index), Enum->Name == value))
-                            Enum->Name = value;
+                            Enum->Name = value, edited = true;
                 }
             }
             else
-                I::InputTextWithHint("##Name", "Enum Name", &Enum->Name);
+                edited |= I::InputTextWithHint("##Name", "Enum Name", &Enum->Name);
         }
 
         auto const e = GetEnum();
 
-        I::Checkbox("Flags", &e->Flags);
+        edited |= I::Checkbox("Flags", &e->Flags);
         
         if (scoped::WithStyleVar(ImGuiStyleVar_CellPadding, ImVec2()))
         if (scoped::Table("Values", 5, ImGuiTableFlags_NoSavedSettings | ImGuiTableFlags_ScrollY, { 0, std::min(200.0f, I::GetFrameHeight() * (e->Values.size() + 1)) }))
@@ -295,11 +316,13 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
 
                 I::TableNextColumn();
                 I::SetNextItemWidth(-FLT_MIN);
-                I::InputText("##InputEnumName", &name);
+                edited |= I::InputText("##InputEnumName", &name);
                 if (I::TableNextColumn(); I::Button(ICON_FA_MINUS "##RemoveEnum", { I::GetFrameHeight(), I::GetFrameHeight() }))
                     remove.emplace(value);
                 if (I::TableNextColumn(); e->Flags ? value > 1 && !e->Values.contains(value >> 1) : value > 0 && !e->Values.contains(value - 1))
                     if (I::Button(ICON_FA_ARROW_UP_FROM_LINE "##ShiftBackEnum", { I::GetFrameHeight(), I::GetFrameHeight() }))
+                    {
+                        edited = true;
                         for (auto itr = e->Values.begin(); itr != e->Values.end(); ++itr)
                             if (itr->first >= value)
                             {
@@ -308,8 +331,11 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                                 v = e->Flags ? v >> 1 : v - 1;
                                 e->Values.insert(std::move(node));
                             }
+                    }
                 if (I::TableNextColumn(); true)
                     if (I::Button(ICON_FA_ARROW_DOWN_FROM_LINE "##ShiftForwardEnum", { I::GetFrameHeight(), I::GetFrameHeight() }))
+                    {
+                        edited = true;
                         for (auto itr = e->Values.rbegin(); itr != e->Values.rend(); ++itr)
                             if (itr->first >= value)
                             {
@@ -318,9 +344,10 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                                 v = e->Flags ? v << 1 : v + 1;
                                 e->Values.insert(std::move(node));
                             }
+                    }
             }
             if (remove)
-                e->Values.erase(*remove);
+                e->Values.erase(*remove), edited = true;
 
             static Enum::UnderlyingType value;
             static std::string name;
@@ -344,6 +371,7 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
             if (I::TableNextColumn(); I::Button(ICON_FA_PLUS "##AddEnum", { I::GetFrameHeight(), I::GetFrameHeight() }))
             {
                 e->Values.emplace(value, name);
+                edited = true;
                 value = e->Flags ? value << 1 : value + 1;
                 name.clear();
             }
@@ -363,6 +391,9 @@ void TypeInfo::Symbol::DrawOptions(TypeInfo& typeInfo, LayoutStack const& layout
                 if (scoped::TabItem(std::format("{} {}", icon, name).c_str()))
                     settings();
     }
+
+    if (edited)
+        NotifyLayoutEdited();
 }
 void TypeInfo::Symbol::Draw(byte const* data, DrawType draw, ContentObject const& content)
 {
@@ -445,6 +476,46 @@ void from_json(ordered_json const& json, TypeInfo::StructLayout& self)
         self.Symbols.emplace(symbol.value("Offset", 0), symbol.get<TypeInfo::Symbol>());
 }
 
+std::optional<TypeInfo::CompiledCondition> TypeInfo::StructLayout::GetCompiledCondition(Symbol const& symbol) const
+{
+    // Conditions are tested for every symbol of every traversed object, so their fields are only looked up by name once per layout revision
+    auto const revision = GetLayoutRevision();
+    auto table = Compiled.Current.load(std::memory_order_acquire);
+    if (!table || table->Revision != revision)
+    {
+        std::scoped_lock _(Compiled.Lock);
+        table = Compiled.Current.load(std::memory_order_relaxed);
+        if (!table || table->Revision != revision)
+        {
+            std::unordered_map<std::string_view, std::pair<uint32, SymbolType const*>> fields;
+            for (auto const& [offset, field] : Symbols)
+                fields.try_emplace(field.Name, offset, field.Type.empty() ? nullptr : field.GetType());
+
+            auto rebuilt = std::make_unique<CompiledConditions::Table>(revision);
+            for (auto const& owner : Symbols | std::views::values)
+            {
+                if (!owner.Condition || owner.Condition->Field.empty())
+                    continue;
+
+                auto const itr = fields.find(owner.Condition->Field);
+                rebuilt->Conditions.emplace(&owner, CompiledCondition
+                {
+                    .Offset = itr != fields.end() ? itr->second.first : 0,
+                    .Type = itr != fields.end() ? itr->second.second : nullptr,
+                    .Value = owner.Condition->Value,
+                    .Test = owner.Condition->Compile(),
+                });
+            }
+            table = Compiled.Tables.emplace_back(std::move(rebuilt)).get();
+            Compiled.Current.store(table, std::memory_order_release);
+        }
+    }
+
+    if (auto const itr = table->Conditions.find(&symbol); itr != table->Conditions.end())
+        return itr->second;
+    return { };
+}
+
 void TypeInfo::Initialize(ContentTypeInfo const& typeInfo)
 {
     if (!Layout.Autogenerated)
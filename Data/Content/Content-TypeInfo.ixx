@@ -45,20 +45,22 @@ struct TypeInfo
             , Value
         )
 
-        [[nodiscard]] bool Test(ValueType value) const
+        using Predicate = bool(*)(ValueType value, ValueType operand);
+        [[nodiscard]] Predicate Compile() const
         {
             switch (Comparison)
             {
                 using enum Comparisons;
-                case Equal:          return value == Value;
-                case NotEqual:       return value != Value;
-                case Less:           return value <  Value;
-                case LessOrEqual:    return value <= Value;
-                case Greater:        return value >  Value;
-                case GreaterOrEqual: return value >= Value;
-                default: assert("Unhandled TypeInfo::Condition::Comparisons"); return false;
+                case Equal:          return [](ValueType value, ValueType operand) { return value == operand; };
+                case NotEqual:       return [](ValueType value, ValueType operand) { return value != operand; };
+                case Less:           return [](ValueType value, ValueType operand) { return value <  operand; };
+                case LessOrEqual:    return [](ValueType value, ValueType operand) { return value <= operand; };
+                case Greater:        return [](ValueType value, ValueType operand) { return value >  operand; };
+                case GreaterOrEqual: return [](ValueType value, ValueType operand) { return value >= operand; };
+                default: assert("Unhandled TypeInfo::Condition::Comparisons"); return [](ValueType, ValueType) { return false; };
             }
         }
+        [[nodiscard]] bool Test(ValueType value) const { return Compile()(value, Value); }
 
         bool operator==(Condition const&) const = default;
     };
@@ -110,12 +112,39 @@ struct TypeInfo
         virtual void Draw(Context const& context) const = 0;
     };
     using SymbolMap = std::multimap<uint32, Symbol>;
+    struct CompiledCondition
+    {
+        uint32 Offset = 0;
+        SymbolType const* Type = nullptr; // Null if the layout has no symbol with the name of the condition's field
+        Condition::ValueType Value = 0;
+        Condition::Predicate Test = nullptr;
+    };
+    // Conditions of a layout's symbols with their fields resolved, rebuilt on first use after layouts are edited. Copies of a layout start out empty.
+    struct CompiledConditions
+    {
+        struct Table
+        {
+            uint32 Revision = 0;
+            std::unordered_map<Symbol const*, CompiledCondition> Conditions;
+        };
+        // Tables are never modified or freed once published, so readers use them without holding a reference. Replaced tables are kept
+        // until the layout is destroyed, which costs little since they're only replaced after layouts are edited by hand.
+        std::atomic<Table const*> Current = nullptr;
+        std::mutex Lock;
+        std::vector<std::unique_ptr<Table const>> Tables; // Owns the current table and every replaced one
+
+        CompiledConditions() = default;
+        CompiledConditions(CompiledConditions const&) { }
+        CompiledConditions& operator=(CompiledConditions const&) { Current = nullptr; return *this; }
+    };
     struct StructLayout
     {
         SymbolMap Symbols;
         bool Autogenerated = false; // Don't serialize
+        mutable CompiledConditions Compiled; // Don't serialize
 
         void Initialize(ContentTypeInfo const& typeInfo);
+        [[nodiscard]] std::optional<CompiledCondition> GetCompiledCondition(Symbol const& symbol) const;
 
         friend void to_json(ordered_json& json, StructLayout const& self);
         friend void from_json(ordered_json const& json, StructLayout& self);
@@ -1,8 +1,10 @@
 export module GW2Viewer.Data.Content;
+export import :ContentByteMap;
 export import :ContentFilter;
 export import :ContentName;
 export import :ContentNamespace;
 export import :ContentObject;
+export import :DisplayNameCache;
 export import :ContentTypeInfo;
 export import :Symbols;
 export import :Query;
@@ -0,0 +1,306 @@
+export module GW2Viewer.Data.Content.ContentDiff;
+import GW2Viewer.Common;
+import GW2Viewer.Common.JSON;
+import GW2Viewer.Data.Content;
+import GW2Viewer.Utils.Async.ProgressBarContext;
+import GW2Viewer.Utils.Encoding;
+import GW2Viewer.Utils.OrderedOutput;
+import std;
+
+export namespace GW2Viewer::Data::Content
+{
+
+// Exported symbol data of an object flattened into scalar fields, so that builds can be compared without keeping both of them loaded
+struct ContentDiffRecord
+{
+    std::string Key;
+    std::vector<std::pair<std::string, std::string>> Fields; // JSON pointer and dumped value of every scalar, sorted by pointer
+};
+
+struct ContentDiffType
+{
+    std::string Name; // Display name of the type at the time, only written alongside its index to make the output readable
+    std::vector<ContentDiffRecord> Records; // Sorted by key
+};
+
+struct ContentDiffSnapshot
+{
+    uint32 Build = 0;
+    std::map<uint32, ContentDiffType> Types; // By type index
+};
+
+struct ContentDiffSummary
+{
+    size_t Added = 0;
+    size_t Removed = 0;
+    size_t Changed = 0;
+    size_t Unchanged = 0;
+
+    ContentDiffSummary& operator+=(ContentDiffSummary const& other)
+    {
+        Added += other.Added;
+        Removed += other.Removed;
+        Changed += other.Changed;
+        Unchanged += other.Unchanged;
+        return *this;
+    }
+};
+
+// Objects are matched across builds by type index and GUID, falling back to UID, data ID and full name for types that lack them.
+// Type indices only change when the game adds or removes types, unlike the names they're given in the viewer, which can be edited at any time.
+// Snapshots and diffs are both written as NDJSON in type index and key order, so the same builds always produce the same files.
+class ContentDiff
+{
+public:
+    static inline std::filesystem::path const SnapshotsDirectory = R"(Export\Game Content\diff\snapshots)";
+    [[nodiscard]] static std::filesystem::path GetSnapshotPath(uint32 build) { return SnapshotsDirectory / std::format("{}.ndjson", build); }
+    [[nodiscard]] static std::filesystem::path GetDiffPath(uint32 beforeBuild, uint32 afterBuild) { return SnapshotsDirectory.parent_path() / std::format("{}-{}.ndjson", beforeBuild, afterBuild); }
+
+    static void SaveSnapshot(std::span<ContentTypeInfo const* const> types, uint32 build, std::ostream& output, Utils::Async::ProgressBarContext& progress)
+    {
+        auto const current = GetTypesByIndex(types);
+        output << ordered_json { { "Build", build } }.dump() << '\n';
+
+        Utils::OrderedOutput::Writer writer { output, current.size() };
+        std::atomic<size_t> processed = 0;
+        progress.Start("Capturing content symbol data", current.size());
+        std::for_each(std::execution::par, current.begin(), current.end(), [&](ContentTypeInfo const* const& type)
+        {
+            auto const name = Utils::Encoding::ToUTF8(type->GetDisplayName());
+            std::string buffer;
+            for (auto const& [key, fields] : CaptureType(*type))
+                (buffer += Utils::OrderedOutput::DumpLine({ { "Type", type->Index }, { "TypeName", name }, { "Key", key }, { "Fields", fields } })) += '\n';
+            writer.Complete(std::distance(current.data(), &type), std::move(buffer));
+            progress = ++processed;
+        });
+    }
+    [[nodiscard]] static std::optional<ContentDiffSnapshot> LoadSnapshot(std::istream& input, Utils::Async::ProgressBarContext& progress)
+    {
+        progress.Start("Loading content diff snapshot");
+        try
+        {
+            std::string line;
+            if (!std::getline(input, line))
+                return { };
+
+            ContentDiffSnapshot snapshot { .Build = ordered_json::parse(line).at("Build").get<uint32>() };
+            while (std::getline(input, line))
+            {
+                auto const json = ordered_json::parse(line);
+                auto& type = snapshot.Types[json.at("Type").get<uint32>()];
+                type.Name = json.at("TypeName").get<std::string>();
+                type.Records.emplace_back(json.at("Key").get<std::string>(), json.at("Fields").get<std::vector<std::pair<std::string, std::string>>>());
+            }
+            return snapshot;
+        }
+        catch (...)
+        {
+            return { };
+        }
+    }
+
+    // Compares the snapshot of an earlier build against the loaded content, every type is captured and compared on its own in parallel
+    static ContentDiffSummary Diff(ContentDiffSnapshot const& before, std::span<ContentTypeInfo const* const> types, std::ostream& output, Utils::Async::ProgressBarContext& progress)
+    {
+        auto const current = GetTypesByIndex(types);
+        return Diff(before, current | std::views::transform(&ContentTypeInfo::Index), output, progress, [&current](uint32 index)
+        {
+            auto const itr = std::ranges::lower_bound(current, index, std::less(), &ContentTypeInfo::Index);
+            return itr != current.end() && (*itr)->Index == index ? ContentDiffType { Utils::Encoding::ToUTF8((*itr)->GetDisplayName()), CaptureType(**itr) } : ContentDiffType();
+        });
+    }
+    static ContentDiffSummary Diff(ContentDiffSnapshot const& before, ContentDiffSnapshot const& after, std::ostream& output, Utils::Async::ProgressBarContext& progress)
+    {
+        return Diff(before, after.Types | std::views::keys, output, progress, [&after](uint32 index) -> ContentDiffType const&
+        {
+            static ContentDiffType const empty;
+            auto const itr = after.Types.find(index);
+            return itr != after.Types.end() ? itr->second : empty;
+        });
+    }
+
+private:
+    [[nodiscard]] static std::vector<ContentTypeInfo const*> GetTypesByIndex(std::span<ContentTypeInfo const* const> types)
+    {
+        std::vector result { std::from_range, types };
+        std::ranges::sort(result, std::less(), &ContentTypeInfo::Index);
+        return result;
+    }
+    [[nodiscard]] static std::string GetKey(ContentObject const& object)
+    {
+        if (auto const guid = object.GetGUID())
+            return std::format("{}", *guid);
+        if (auto const uid = object.GetUID())
+            return std::format("UID:{}", *uid);
+        if (auto const dataID = object.GetDataID())
+            return std::format("DataID:{}", *dataID);
+        return std::format("Name:{}", Utils::Encoding::ToUTF8(object.GetFullName()));
+    }
+    static void Flatten(ordered_json const& json, std::string& path, std::vector<std::pair<std::string, std::string>>& fields)
+    {
+        auto const size = path.size();
+        if (json.is_object())
+        {
+            for (auto const& [key, value] : json.items())
+            {
+                path += '/';
+                for (auto const c : key)
+                {
+                    if (c == '~')
+                        path += "~0";
+                    else if (c == '/')
+                        path += "~1";
+                    else
+                        path += c;
+                }
+                Flatten(value, path, fields);
+                path.resize(size);
+            }
+        }
+        else if (json.is_array())
+        {
+            for (size_t index = 0; auto const& value : json)
+            {
+                path += std::format("/{}", index++);
+                Flatten(value, path, fields);
+                path.resize(size);
+            }
+        }
+        else
+            fields.emplace_back(path, Utils::OrderedOutput::DumpLine(json));
+    }
+    [[nodiscard]] static std::vector<ContentDiffRecord> CaptureType(ContentTypeInfo const& type)
+    {
+        // Content pointers are exported as GUIDs, which unlike their addresses stay the same across builds
+        static ExportOptions const options { .ContentPointerFormat = ExportOptions::ContentPointerFormats::GUID };
+
+        std::vector<ContentDiffRecord> records;
+        records.reserve(type.Objects.size());
+        std::string path;
+        for (auto const object : type.Objects)
+        {
+            auto& record = records.emplace_back(GetKey(*object));
+            try
+            {
+                object->Finalize();
+                Flatten(ExportSymbolData(*object, options), path, record.Fields);
+            }
+            catch (...) { }
+            std::ranges::sort(record.Fields);
+        }
+
+        // Objects that share a key are told apart by their order within the type
+        std::ranges::stable_sort(records, std::less(), &ContentDiffRecord::Key);
+        for (auto itr = records.begin(); itr != records.end(); )
+        {
+            auto const end = std::find_if(itr, records.end(), [&key = itr->Key](ContentDiffRecord const& record) { return record.Key != key; });
+            if (std::distance(itr, end) > 1)
+                for (auto const& [index, record] : std::ranges::subrange(itr, end) | std::views::enumerate)
+                    record.Key += std::format("#{}", index);
+            itr = end;
+        }
+        std::ranges::sort(records, std::less(), &ContentDiffRecord::Key);
+        return records;
+    }
+
+    [[nodiscard]] static ordered_json DiffFields(std::span<std::pair<std::string, std::string> const> before, std::span<std::pair<std::string, std::string> const> after)
+    {
+        auto delta = [](std::string_view path, std::string const* before, std::string const* after)
+        {
+            return ordered_json
+            {
+                { "Path", path },
+                { "Before", before ? ordered_json::parse(*before) : ordered_json() },
+                { "After", after ? ordered_json::parse(*after) : ordered_json() },
+            };
+        };
+        ordered_json deltas = ordered_json::array();
+        auto b = before.begin();
+        auto a = after.begin();
+        while (b != before.end() || a != after.end())
+        {
+            if (a == after.end() || b != before.end() && b->first < a->first)
+            {
+                deltas.emplace_back(delta(b->first, &b->second, nullptr));
+                ++b;
+            }
+            else if (b == before.end() || a->first < b->first)
+            {
+                deltas.emplace_back(delta(a->first, nullptr, &a->second));
+                ++a;
+            }
+            else
+            {
+                if (b->second != a->second)
+                    deltas.emplace_back(delta(a->first, &b->second, &a->second));
+                ++b;
+                ++a;
+            }
+        }
+        return deltas;
+    }
+    static void DiffType(uint32 type, std::string_view typeName, std::span<ContentDiffRecord const> before, std::span<ContentDiffRecord const> after, std::string& output, ContentDiffSummary& summary)
+    {
+        auto emit = [&](std::string_view change, std::string_view key, ordered_json&& fields = { })
+        {
+            ordered_json json { { "Change", change }, { "Type", type }, { "TypeName", typeName }, { "Key", key } };
+            if (!fields.is_null())
+                json["Fields"] = std::move(fields);
+            (output += Utils::OrderedOutput::DumpLine(json)) += '\n';
+        };
+        auto b = before.begin();
+        auto a = after.begin();
+        while (b != before.end() || a != after.end())
+        {
+            if (a == after.end() || b != before.end() && b->Key < a->Key)
+            {
+                emit("Removed", b++->Key);
+                ++summary.Removed;
+            }
+            else if (b == before.end() || a->Key < b->Key)
+            {
+                emit("Added", a++->Key);
+                ++summary.Added;
+            }
+            else
+            {
+                if (auto deltas = DiffFields(b->Fields, a->Fields); !deltas.empty())
+                {
+                    emit("Changed", a->Key, std::move(deltas));
+                    ++summary.Changed;
+                }
+                else
+                    ++summary.Unchanged;
+                ++b;
+                ++a;
+            }
+        }
+    }
+    static ContentDiffSummary Diff(ContentDiffSnapshot const& before, auto&& afterTypeIndices, std::ostream& output, Utils::Async::ProgressBarContext& progress, auto&& getAfter)
+    {
+        std::vector<uint32> types { std::from_range, before.Types | std::views::keys };
+        types.append_range(afterTypeIndices);
+        std::ranges::sort(types);
+        types.erase(std::ranges::unique(types).begin(), types.end());
+
+        ContentDiffType const none;
+        Utils::OrderedOutput::Writer writer { output, types.size() };
+        std::vector<ContentDiffSummary> summaries(types.size());
+        std::atomic<size_t> processed = 0;
+        progress.Start("Comparing content", types.size());
+        std::for_each(std::execution::par, types.begin(), types.end(), [&](uint32 const& type)
+        {
+            auto const index = std::distance(types.data(), &type);
+            auto const itr = before.Types.find(type);
+            auto const& previous = itr != before.Types.end() ? itr->second : none;
+            auto const& after = getAfter(type);
+            std::string buffer;
+            DiffType(type, !after.Name.empty() ? after.Name : previous.Name, previous.Records, after.Records, buffer, summaries[index]);
+            writer.Complete(index, std::move(buffer));
+            progress = ++processed;
+        });
+        return std::ranges::fold_left(summaries, ContentDiffSummary(), [](ContentDiffSummary result, ContentDiffSummary const& summary) { return result += summary; });
+    }
+};
+
+}
@@ -1,21 +1,461 @@
 ﻿module GW2Viewer.Data.Content.Manager;
 import GW2Viewer.Data.Game;
+import GW2Viewer.UI.Notifications;
 
 namespace GW2Viewer::Data::Content
 {
 
-void Manager::Load(Utils::Async::ProgressBarContext& progress)
+void Manager::Load(Utils::Async::ProgressBarContext& progress, bool parallel)
 {
+    // Content files that were waiting for their decryption keys are already read, so loading resumes by decrypting them
+    std::vector<uint32> encrypted;
+    {
+        std::scoped_lock _(m_encryptedContentFilesMutex);
+        encrypted = std::exchange(m_encryptedContentFiles, { });
+    }
+    if (encrypted.empty())
+    {
+        if (!ReadContentFiles(progress))
+            return;
+        for (auto const& [index, file] : m_loadedContentFiles | std::views::enumerate)
+            if (IsContentFileEncrypted(file))
+                encrypted.emplace_back(index);
+    }
+    if (!DecryptContentFiles(std::move(encrypted), progress))
+        return;
+
+    // Only graphs built by the parallel path are snapshotted, the serial one exists to verify them
+    static std::filesystem::path const snapshotPath = "ContentGraph.bin";
+    if (parallel && LoadSnapshot(snapshotPath, progress))
+    {
+        m_loaded = true;
+        return;
+    }
+
+    Process(progress, parallel);
+    if (parallel)
+        SaveSnapshot(snapshotPath);
+}
+
+bool Manager::ReadContentFiles(Utils::Async::ProgressBarContext& progress)
+{
+    m_loadedContentFiles.clear();
     m_loadedContentFiles.resize(m_numContentFiles);
-    uint32 fileID = m_firstContentFileID;
+    if (m_loadedContentFiles.empty())
+        return false;
+
+    // Reading from the archive is serialized by its own lock, but inflating isn't, so a few workers are enough to keep every core busy
+    std::atomic<uint32> next = 0;
+    std::atomic<size_t> loaded = 0;
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
     progress.Start("Loading content files", m_loadedContentFiles.size());
-    for (auto& loaded : m_loadedContentFiles)
     {
-        loaded.File = G::Game.Archive.GetPackFile(fileID++);
-        ++progress;
+        std::vector<std::jthread> workers(std::min(std::max(std::thread::hardware_concurrency(), 1u), m_numContentFiles));
+        for (auto& worker : workers)
+        {
+            worker = std::jthread([&]
+            {
+                try
+                {
+                    for (uint32 index; (index = next++) < m_numContentFiles; )
+                    {
+                        auto& file = m_loadedContentFiles[index];
+                        file.File = G::Game.Archive.GetPackFile(m_firstContentFileID + index);
+                        if (auto const entry = G::Game.Archive.GetFileEntry(m_firstContentFileID + index); file.File && entry)
+                            file.CRC = Utils::CRC::Calculate(0, { (byte const*)file.File.get(), entry->GetSize() });
+                        progress = ++loaded;
+                    }
+                }
+                catch (...)
+                {
+                    // The other workers stop after their current file, the first exception is rethrown once they're joined
+                    next = m_numContentFiles;
+                    std::scoped_lock _(exceptionMutex);
+                    if (!exception)
+                        exception = std::current_exception();
+                }
+            });
+        }
+    }
+    if (exception)
+        std::rethrow_exception(exception);
+
+    std::vector<uint32> failed;
+    for (auto const& [index, file] : m_loadedContentFiles | std::views::enumerate)
+        if (!file.File)
+            failed.emplace_back(index);
+    if (!failed.empty())
+    {
+        G::Notifications.AddCloseable({ .Text = std::format("Failed to load {} of {} content files:\n{}", failed.size(), m_numContentFiles, FormatContentFileList(failed)) });
+        return false;
+    }
+    return true;
+}
+
+bool Manager::DecryptContentFiles(std::vector<uint32>&& indices, Utils::Async::ProgressBarContext& progress)
+{
+    while (!indices.empty())
+    {
+        // RC4 can't be split within a file, so the files are decrypted in parallel instead, files whose key turns out to be wrong are left as they were
+        auto const keys = indices | std::views::transform([this](uint32 index) { return G::Game.Encryption.GetContentFileKey(m_firstContentFileID + index); }) | std::ranges::to<std::vector>();
+        auto const keyless = std::views::zip(indices, keys) | std::views::filter([](auto const& pair) { return !std::get<1>(pair); }) | std::views::keys | std::ranges::to<std::vector>();
+        std::atomic<size_t> processed = 0;
+        progress.Start("Decrypting content files", indices.size());
+        std::for_each(std::execution::par, indices.begin(), indices.end(), [&](uint32 const& index)
+        {
+            if (auto const& key = keys[std::distance(indices.data(), &index)])
+                DecryptContentFile(m_loadedContentFiles[index], *key);
+            progress = ++processed;
+        });
+        std::erase_if(indices, [this](uint32 index) { return !IsContentFileEncrypted(m_loadedContentFiles[index]); });
+
+        // Keys that arrived since they were looked up would otherwise find no files waiting for them once loading is retried,
+        // files that had a key and are still encrypted had the wrong one
+        std::scoped_lock _(m_encryptedContentFilesMutex);
+        if (!indices.empty() && !HasAnyContentFileKey(keyless))
+        {
+            auto const wrong = indices | std::views::filter([this](uint32 index) { return G::Game.Encryption.GetContentFileKey(m_firstContentFileID + index).has_value(); }) | std::ranges::to<std::vector>();
+            G::Notifications.AddCloseable({ .Text = std::format("Couldn't decrypt {} of {} content files, loading can be resumed from Tools > Content File Keys once their keys are entered:\n{}{}", indices.size(), m_numContentFiles, FormatContentFileList(indices),
+                wrong.empty() ? "" : std::format("\nThe keys entered for {} of them are wrong:\n{}", wrong.size(), FormatContentFileList(wrong))) });
+            m_encryptedContentFiles = std::move(indices);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Manager::HasAnyContentFileKey(std::span<uint32 const> indices) const
+{
+    return std::ranges::any_of(indices, [this](uint32 index) { return G::Game.Encryption.GetContentFileKey(m_firstContentFileID + index).has_value(); });
+}
+
+std::string Manager::FormatContentFileList(std::span<uint32 const> indices) const
+{
+    return indices | std::views::transform([this](uint32 index) { return std::format("#{} (file {})", index, m_firstContentFileID + index); }) | std::views::join_with(std::string_view(", ")) | std::ranges::to<std::string>();
+}
+
+uint64 Manager::GetGraphHash() const
+{
+    uint64 hash = 0xCBF29CE484222325;
+    auto add = [&hash](uint64 value)
+    {
+        for (uint32 i = 0; i < sizeof(value); ++i, value >>= 8)
+            hash = (hash ^ (value & 0xFF)) * 0x100000001B3;
+    };
+    auto addIndex = [&add](auto const* object) { add(object ? object->Index : (uint32)-1); };
+    auto addObjects = [&](std::span<ContentObject const* const> objects)
+    {
+        add(objects.size());
+        for (auto const object : objects)
+            addIndex(object);
+    };
+    auto addReferences = [&](std::span<ContentObject::Reference const> references)
+    {
+        add(references.size());
+        for (auto const& [object, type] : references)
+        {
+            addIndex(object);
+            add((uint64)type);
+        }
+    };
+
+    add(m_typeInfos.size());
+    for (auto const type : m_typeInfos)
+        addObjects(type->Objects);
+
+    add(m_namespaces.size());
+    for (auto const ns : m_namespaces)
+    {
+        addIndex(ns->Parent);
+        add(ns->Namespaces.size());
+        for (auto const child : ns->Namespaces)
+            addIndex(child);
+        addObjects(ns->Entries);
+    }
+
+    add(m_objects.size());
+    for (auto const object : m_objects)
+    {
+        addIndex(object);
+        addIndex(object->Type);
+        addIndex(object->Namespace);
+        addIndex(object->Root);
+        add(object->ContentFileEntryOffset);
+        addObjects(object->Entries);
+        addReferences(object->OutgoingReferences);
+        addReferences(object->IncomingReferences);
+    }
+    addObjects(m_rootedObjects);
+    addObjects(m_unrootedObjects);
+    return hash;
+}
+
+std::string Manager::BenchmarkLookupTables() const
+{
+    auto time = [](auto&& func)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    // Tree nodes hold three links and two flags before the value and come from a heap with 16 byte granularity
+    auto nodeSize = [](size_t valueSize) { return (4 * sizeof(void*) + valueSize + 15) / 16 * 16; };
+    auto formatSize = [](size_t bytes) { return std::format("{:.1f} MB", bytes / (double)(1 << 20)); };
+
+    std::mt19937 random;
+    auto pointers = m_contentDataPointers;
+    std::ranges::shuffle(pointers, random);
+    std::vector<std::pair<byte const*, byte const*>> references;
+    references.reserve(m_references.Targets.size());
+    for (auto const& [index, source] : m_references.Sources | std::views::enumerate)
+        for (auto const target : m_references.GetTargets(index))
+            references.emplace_back(source, target);
+    std::ranges::shuffle(references, random);
+
+    std::string report;
+    size_t checksum = 0;
+
+    {
+        std::set<byte const*> tree;
+        std::vector<byte const*> flat;
+        auto const treeBuild = time([&] { tree.insert(pointers.begin(), pointers.end()); });
+        auto const flatBuild = time([&]
+        {
+            flat = pointers;
+            Utils::Container::SortAndDeduplicate(flat);
+        });
+        auto const treeLookup = time([&]
+        {
+            for (auto const& [source, target] : references)
+                checksum += *--tree.upper_bound(target) == target;
+        });
+        auto const flatLookup = time([&]
+        {
+            for (auto const& [source, target] : references)
+                checksum += *(Utils::Container::BranchlessUpperBound(flat, target) - 1) == target;
+        });
+        report += std::format("Content pointers ({} entries, {} lookups)\n  Build: {:.1f} ms -> {:.1f} ms\n  Lookup: {:.1f} ms -> {:.1f} ms\n  Memory: {} -> {}\n",
+            flat.size(), references.size(), treeBuild, flatBuild, treeLookup, flatLookup, formatSize(tree.size() * nodeSize(sizeof(byte const*))), formatSize(flat.capacity() * sizeof(byte const*)));
+    }
+
+    {
+        std::map<byte const*, std::set<byte const*>> tree;
+        ReferenceTable flat;
+        auto input = references;
+        auto const treeBuild = time([&]
+        {
+            for (auto const& [source, target] : references)
+                tree[source].emplace(target);
+        });
+        auto const flatBuild = time([&] { flat.Build(std::move(input)); });
+        auto const treeIterate = time([&]
+        {
+            for (auto const& [source, targets] : tree)
+                for (auto const target : targets)
+                    checksum += target > source;
+        });
+        auto const flatIterate = time([&]
+        {
+            for (auto const& [index, source] : flat.Sources | std::views::enumerate)
+                for (auto const target : flat.GetTargets(index))
+                    checksum += target > source;
+        });
+        size_t const treeBytes = tree.size() * (nodeSize(sizeof(byte const*) + sizeof(std::set<byte const*>)) + nodeSize(sizeof(byte const*))) + flat.Targets.size() * nodeSize(sizeof(byte const*));
+        size_t const flatBytes = flat.Sources.capacity() * sizeof(byte const*) + flat.Offsets.capacity() * sizeof(uint32) + flat.Targets.capacity() * sizeof(byte const*);
+        report += std::format("Content references ({} sources, {} targets)\n  Build: {:.1f} ms -> {:.1f} ms\n  Iterate: {:.1f} ms -> {:.1f} ms\n  Memory: {} -> {}\n",
+            flat.size(), flat.Targets.size(), treeBuild, flatBuild, treeIterate, flatIterate, formatSize(treeBytes), formatSize(flatBytes));
+    }
+
+    {
+        double treeBuild = 0, flatBuild = 0, treeLookup = 0, flatLookup = 0;
+        size_t treeBytes = 0, flatBytes = 0, boundaries = 0, lookups = 0;
+        for (auto const& loaded : m_loadedContentFiles)
+        {
+            auto input = loaded.EntryBoundaries;
+            std::ranges::shuffle(input, random);
+            std::set<uint32> tree;
+            std::vector<uint32> flat;
+            treeBuild += time([&] { tree.insert(input.begin(), input.end()); });
+            flatBuild += time([&]
+            {
+                flat = input;
+                Utils::Container::SortAndDeduplicate(flat);
+            });
+            treeLookup += time([&]
+            {
+                for (auto const& object : loaded.Objects)
+                    checksum += *tree.upper_bound(object->ContentFileEntryOffset);
+            });
+            flatLookup += time([&]
+            {
+                for (auto const& object : loaded.Objects)
+                    checksum += *Utils::Container::BranchlessUpperBound(flat, object->ContentFileEntryOffset);
+            });
+            treeBytes += tree.size() * nodeSize(sizeof(uint32));
+            flatBytes += flat.capacity() * sizeof(uint32);
+            boundaries += flat.size();
+            lookups += loaded.Objects.size();
+        }
+        report += std::format("Entry boundaries ({} entries, {} lookups)\n  Build: {:.1f} ms -> {:.1f} ms\n  Lookup: {:.1f} ms -> {:.1f} ms\n  Memory: {} -> {}",
+            boundaries, lookups, treeBuild, flatBuild, treeLookup, flatLookup, formatSize(treeBytes), formatSize(flatBytes));
+    }
+
+    return std::format("{}\nChecksum: {}", report, checksum);
+}
+
+std::string Manager::BenchmarkObjectLookups() const
+{
+    auto time = [](auto&& func)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        func();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    };
+    // List nodes hold two links before the value, the bucket array holds two iterators per bucket
+    auto hashMapSize = [](auto const& map) { return map.size() * ((2 * sizeof(void*) + sizeof(*map.begin()) + 15) / 16 * 16) + map.bucket_count() * 2 * sizeof(void*); };
+    auto formatSize = [](size_t bytes) { return std::format("{:.1f} MB", bytes / (double)(1 << 20)); };
+
+    std::mt19937 random;
+    std::string report;
+    size_t checksum = 0;
+
+    // Linear scans are quadratic over the whole type, so they only get a sample of the keys
+    static constexpr size_t LinearScanSamples = 256;
+    auto benchmarkIDs = [&](char const* description, int32 ContentTypeInfo::* offset, uint32 const* (ContentObject::* getID)() const, decltype(TypeObjectLookup::ByDataID) TypeObjectLookup::* getTable)
+    {
+        double linearLookup = 0, hashBuild = 0, hashLookup = 0, tableLookup = 0;
+        size_t linearLookups = 0, lookups = 0, hashBytes = 0, tableBytes = 0;
+        for (auto const type : m_typeInfos)
+        {
+            if (type->*offset < 0)
+                continue;
+
+            std::vector<uint32> keys;
+            keys.reserve(type->Objects.size());
+            for (auto const object : type->Objects)
+                keys.emplace_back(*(object->*getID)());
+            std::ranges::shuffle(keys, random);
+
+            auto const samples = std::span(keys).first(std::min(keys.size(), LinearScanSamples));
+            linearLookup += time([&]
+            {
+                for (auto const key : samples)
+                    checksum += std::ranges::find(type->Objects, key, [getID](ContentObject const* object) { return *(object->*getID)(); }) != type->Objects.end();
+            });
+            linearLookups += samples.size();
+
+            std::unordered_map<uint32, ContentObject const*> hash;
+            hashBuild += time([&]
+            {
+                hash.reserve(type->Objects.size());
+                for (auto const object : type->Objects)
+                    hash.emplace(*(object->*getID)(), object);
+            });
+            hashLookup += time([&]
+            {
+                for (auto const key : keys)
+                    checksum += hash.find(key)->second->Index;
+            });
+            auto const& table = m_objectsByTypeID.at(type->Index).*getTable;
+            tableLookup += time([&]
+            {
+                for (auto const key : keys)
+                    checksum += table.find(key)->second->Index;
+            });
+            lookups += keys.size();
+            hashBytes += hashMapSize(hash);
+            tableBytes += table.GetMemoryUsage();
+        }
+        report += std::format("{} ({} lookups)\n  Linear scan: {:.1f} ns\n  unordered_map: {:.1f} ns, built in {:.1f} ms, {}\n  Open addressing: {:.1f} ns, {}\n",
+            description, lookups, linearLookup / std::max<size_t>(linearLookups, 1), hashLookup / std::max<size_t>(lookups, 1), hashBuild / 1e6, formatSize(hashBytes), tableLookup / std::max<size_t>(lookups, 1), formatSize(tableBytes));
+    };
+    benchmarkIDs("Data IDs", &ContentTypeInfo::DataIDOffset, &ContentObject::GetDataID, &TypeObjectLookup::ByDataID);
+
+    auto benchmarkKeys = [&](char const* description, auto keys, auto const& table)
+    {
+        std::ranges::shuffle(keys, random);
+        std::unordered_map<typename decltype(keys)::value_type, void const*> hash;
+        auto const hashBuild = time([&]
+        {
+            hash.reserve(table.size());
+            for (auto const& [key, value] : table)
+                hash.emplace(key, &value);
+        });
+        auto const hashLookup = time([&]
+        {
+            for (auto const& key : keys)
+                checksum += (size_t)hash.find(key)->second;
+        });
+        auto const tableLookup = time([&]
+        {
+            for (auto const& key : keys)
+                checksum += (size_t)&table.find(key)->second;
+        });
+        report += std::format("{} ({} lookups)\n  unordered_map: {:.1f} ns, built in {:.1f} ms, {}\n  Open addressing: {:.1f} ns, {}\n",
+            description, keys.size(), hashLookup / std::max<size_t>(keys.size(), 1), hashBuild / 1e6, formatSize(hashMapSize(hash)), tableLookup / std::max<size_t>(keys.size(), 1), formatSize(table.GetMemoryUsage()));
+    };
+    benchmarkKeys("GUIDs", m_objectsByGUID | std::views::keys | std::ranges::to<std::vector>(), m_objectsByGUID);
+    benchmarkKeys("Names", m_objectsByName | std::views::keys | std::ranges::to<std::vector>(), m_objectsByName);
+
+    // Conditions are looked up for every symbol of every traversed object from all threads at once, which is compared against
+    // publishing the tables through a shared_ptr, where every lookup takes and drops a reference on the same control block
+    {
+        using Table = TypeInfo::CompiledConditions::Table;
+        struct Lookup
+        {
+            TypeInfo::StructLayout const* Layout;
+            TypeInfo::Symbol const* Symbol;
+            std::atomic<std::shared_ptr<Table const>> const* Shared;
+        };
+        std::unordered_map<TypeInfo::StructLayout const*, std::atomic<std::shared_ptr<Table const>>> sharedTables;
+        std::vector<Lookup> conditions;
+        for (auto const type : m_typeInfos)
+        {
+            auto const& layout = type->GetTypeInfo().Layout;
+            for (auto const& symbol : layout.Symbols | std::views::values)
+            {
+                if (!symbol.Condition || symbol.Condition->Field.empty() || !layout.GetCompiledCondition(symbol))
+                    continue;
+
+                auto& shared = sharedTables[&layout];
+                if (!shared.load())
+                    shared = std::make_shared<Table const>(*layout.Compiled.Current.load());
+                conditions.emplace_back(&layout, &symbol, &shared);
+            }
+        }
+
+        std::vector<size_t> threads(std::max(std::thread::hardware_concurrency(), 1u) * 4);
+        auto benchmarkConditions = [&](auto&& lookup)
+        {
+            std::atomic<size_t> sum = 0;
+            auto const elapsed = time([&]
+            {
+                std::for_each(std::execution::par, threads.begin(), threads.end(), [&](size_t)
+                {
+                    size_t local = 0;
+                    for (auto const& condition : conditions)
+                        local += lookup(condition);
+                    sum += local;
+                });
+            });
+            checksum += sum;
+            return elapsed / std::max<size_t>(conditions.size() * threads.size(), 1);
+        };
+        auto const sharedLookup = benchmarkConditions([](Lookup const& condition)
+        {
+            auto const table = condition.Shared->load(std::memory_order_acquire);
+            return (size_t)(table->Revision == GetLayoutRevision()) + table->Conditions.find(condition.Symbol)->second.Offset;
+        });
+        auto const publishedLookup = benchmarkConditions([](Lookup const& condition)
+        {
+            return (size_t)condition.Layout->GetCompiledCondition(*condition.Symbol)->Offset;
+        });
+        report += std::format("Symbol conditions ({} lookups in parallel)\n  shared_ptr table: {:.1f} ns\n  Published table: {:.1f} ns\n",
+            conditions.size() * threads.size(), sharedLookup, publishedLookup);
     }
 
-    Process(progress);
+    return std::format("{}Checksum: {}", report, checksum);
 }
 
 }
@@ -1,15 +1,22 @@
+module;
+#include <mio/mmap.hpp>
+
 export module GW2Viewer.Data.Content.Manager;
 import GW2Viewer.Common;
 import GW2Viewer.Common.FourCC;
 import GW2Viewer.Common.GUID;
 import GW2Viewer.Content;
 import GW2Viewer.Data.Content;
+import GW2Viewer.Data.Content.NameIndex;
+import GW2Viewer.Data.Content.SymbolValueIndex;
+import GW2Viewer.Data.Encryption.RC4;
 import GW2Viewer.Data.Pack;
 import GW2Viewer.Data.Pack.PackFile;
 import GW2Viewer.User.Config;
 import GW2Viewer.Utils.Async.ProgressBarContext;
 import GW2Viewer.Utils.ConstString;
 import GW2Viewer.Utils.Container;
+import GW2Viewer.Utils.CRC;
 import std;
 import <cassert>;
 import <cstring>;
@@ -79,6 +86,48 @@ struct PackContent
     Pack::Array<Pack::WString64> strings;
     Pack::Array<byte> content;
 };
+
+// Processed object graph, stored as fixed size records that reference each other by index
+struct ContentSnapshotHeader
+{
+    static constexpr byte CurrentVersion = 3;
+
+    uint32 FourCC = std::byteswap('GW2V');
+    uint32 FourCC2 = std::byteswap('CGRF');
+    byte Version = CurrentVersion;
+    byte Reserved0 = 0;
+    byte Reserved1 = 0;
+    byte Reserved2 = 0;
+    uint32 NumFiles = 0;
+    uint64 LayoutHash = 0;
+    uint32 NumBoundaries = 0;
+    uint32 NumObjects = 0;
+    uint32 NumOutgoingReferences = 0;
+    uint32 NumIncomingReferences = 0;
+    uint32 NumFileReferences = 0;
+    byte Reserved[0x40 - 0x2C] { };
+};
+static_assert(sizeof(ContentSnapshotHeader) == 0x40);
+struct ContentSnapshotFile
+{
+    uint32 CRC;
+    uint32 NumBoundaries;
+    uint32 NumObjects;
+};
+struct ContentSnapshotObject
+{
+    uint32 Type;
+    uint32 Namespace;
+    int32 Root;
+    uint32 Offset;
+    uint32 FirstOutgoingReference;
+    uint32 FirstIncomingReference;
+};
+struct ContentSnapshotReference
+{
+    uint32 Object;
+    uint32 Type;
+};
 #pragma pack(pop)
 #else
 template<ConstString... Fields>
@@ -91,41 +140,35 @@ export
 class Manager
 {
 public:
-    void Load(Utils::Async::ProgressBarContext& progress);
-    void Process(Utils::Async::ProgressBarContext& progress)
+    // Only decrypts the content files that were waiting for their keys if it's called again after a previous call stopped because of them
+    void Load(Utils::Async::ProgressBarContext& progress, bool parallel = true);
+    [[nodiscard]] std::vector<uint32> GetEncryptedFileIDs() const
     {
-        std::array<std::tuple<PostProcessStage, char const*>, 3> STAGES
-        { {
-            { PostProcessStage::GatherContentPointers, "Marking content pointers" },
-            { PostProcessStage::ProcessFixupsAndCreateObjects, "Processing content files" },
-            { PostProcessStage::ProcessTrackedReferences, "Processing tracked references" },
-        } };
-        for (auto const& [stage, description] : STAGES)
-        {
-            progress.Start(description, m_loadedContentFiles.size());
-            for (auto& loaded : m_loadedContentFiles)
-            {
-                PostProcessContentFile(loaded, stage);
-                ++progress;
-            }
-        }
-        assert(GetNamespaceRoot());
-
-        m_loadedObjects = true;
-
-        progress.Start("Processing all references", m_references.size());
-        for (auto const& [source, targets] : m_references)
-        {
-            auto* sourceObject = GetByDataPointerMutable(source);
-            for (auto const& target : targets)
-                sourceObject->AddReference(*GetByDataPointerMutable(target), ContentObject::Reference::Types::All);
-            ++progress;
-        }
+        std::scoped_lock _(m_encryptedContentFilesMutex);
+        return m_encryptedContentFiles | std::views::transform([this](uint32 index) { return m_firstContentFileID + index; }) | std::ranges::to<std::vector>();
+    }
+    void Process(Utils::Async::ProgressBarContext& progress, bool parallel = true)
+    {
+        #ifdef NATIVE
+        if (parallel)
+            ProcessParallel(progress);
+        else
+        #endif
+            ProcessSerial(progress);
 
+        #ifdef NATIVE
+        BuildFileReferences(progress);
+        #endif
         m_loaded = true;
     }
     [[nodiscard]] bool IsLoaded() const { return m_loaded; }
     [[nodiscard]] auto GetFileIDs() const { return std::views::iota(m_firstContentFileID) | std::views::take(m_numContentFiles); }
+    // Hash of the processed object, namespace and reference graph, independent of where the content files were allocated
+    [[nodiscard]] uint64 GetGraphHash() const;
+    // Rebuilds the lookup tables used during processing both as node based containers and as flat arrays, and reports timings and memory use
+    [[nodiscard]] std::string BenchmarkLookupTables() const;
+    // Compares the object lookups by data ID, GUID and name against linear scans and node based hash maps
+    [[nodiscard]] std::string BenchmarkObjectLookups() const;
 
     [[nodiscard]] bool AreTypesLoaded() const { return m_loadedTypes; }
     [[nodiscard]] uint32 GetNumTypes() const { return m_typeInfos.size(); }
@@ -160,17 +203,22 @@ public:
     [[nodiscard]] ContentObject const* GetByIndex(uint32 index) const { return m_objects.at(index); }
     [[nodiscard]] ContentObject const* GetByGUID(GUID const& guid) const { if (auto const object = Utils::Container::Find(m_objectsByGUID, guid)) return *object; return nullptr; }
     [[nodiscard]] ContentObject const* GetByDataPointer(byte const* ptr) const { return GetByDataPointerMutable(ptr); }
+    [[nodiscard]] ContentObject const* GetByDataID(ContentTypeInfo const& type, uint32 dataID) const
+    {
+        if (type.DataIDOffset < 0)
+            std::terminate();
+
+        // Lookups are built after the objects, until then nothing can be found
+        if (type.Index >= m_objectsByTypeID.size())
+            return nullptr;
+        if (auto const object = Utils::Container::Find(m_objectsByTypeID[type.Index].ByDataID, dataID))
+            return *object;
+        return nullptr;
+    }
     [[nodiscard]] ContentObject const* GetByDataID(GW2Viewer::Content::EContentTypes type, uint32 dataID) const
     {
         if (auto const typeInfo = GetType(type))
-        {
-            if (typeInfo->DataIDOffset < 0)
-                std::terminate();
-
-            for (auto const object : typeInfo->Objects)
-                if (*object->GetDataID() == dataID)
-                    return object;
-        }
+            return GetByDataID(*typeInfo, dataID);
 
         return nullptr;
     }
@@ -178,6 +226,63 @@ public:
     [[nodiscard]] auto GetByName(std::wstring_view name) const { return Utils::Container::Find(m_objectsByName, name); }
     [[nodiscard]] auto GetNamespacesByName(std::wstring_view name) const { return Utils::Container::Find(m_namespacesByName, name); }
 
+    // Objects whose data contains the file ID, in index order. Found in O(log n) from the file index fixups, independently of struct layouts.
+    [[nodiscard]] auto GetFileReferences(uint32 fileID) const
+    {
+        auto const begin = std::distance(m_fileReferenceIDs.data(), Utils::Container::BranchlessLowerBound(m_fileReferenceIDs, fileID));
+        auto const end = std::distance(m_fileReferenceIDs.data(), Utils::Container::BranchlessUpperBound(m_fileReferenceIDs, fileID));
+        return std::span(m_fileReferenceObjects).subspan(begin, end - begin) | std::views::transform([this](uint32 index) { return GetByIndex(index); });
+    }
+
+    void BuildNameIndex(Utils::Async::ProgressBarContext& progress) { m_nameIndex.Build(GetObjects(), progress); }
+    // Rebuilds the name index in the background if display settings changed since it was last built
+    void UpdateNameIndex()
+    {
+        std::scoped_lock _(m_nameIndexUpdateMutex);
+        if (m_nameIndex.IsBuilt() && !m_nameIndex.IsCurrent() && !m_nameIndexUpdate.IsRunning())
+            m_nameIndexUpdate.Run([this](Utils::Async::ProgressBarContext& progress) { BuildNameIndex(progress); });
+    }
+    // Objects whose names or display names might contain the search text, or nothing if the name index can't narrow the search down.
+    // Custom names aren't indexed, so objects that have one are always candidates.
+    [[nodiscard]] std::optional<std::vector<bool>> GetNameCandidates(std::wstring_view search) const
+    {
+        auto candidates = m_nameIndex.GetCandidates(search);
+        if (candidates)
+            for (auto const& guid : G::Config.ContentObjectNames | std::views::keys)
+                if (auto const object = GetByGUID(guid); object && object->Index < candidates->size())
+                    (*candidates)[object->Index] = true;
+        return candidates;
+    }
+
+    void BuildSymbolValueIndex(Utils::Async::ProgressBarContext& progress) { m_symbolValueIndex.Build(GetObjects(), progress); }
+    // Rebuilds the symbol value index in the background if struct layouts were edited since it was last built
+    void UpdateSymbolValueIndex()
+    {
+        std::scoped_lock _(m_symbolValueIndexUpdateMutex);
+        if (m_symbolValueIndex.IsBuilt() && !m_symbolValueIndex.IsCurrent() && !m_symbolValueIndexUpdate.IsRunning())
+            m_symbolValueIndexUpdate.Run([this](Utils::Async::ProgressBarContext& progress) { BuildSymbolValueIndex(progress); });
+    }
+    // Objects containing a symbol of the given type with the given value, or nothing if the symbol value index can't answer the query
+    [[nodiscard]] std::optional<std::vector<ContentObject const*>> FindBySymbolValue(TypeInfo::SymbolType const& type, TypeInfo::Condition::ValueType value) const
+    {
+        if (auto const indices = m_symbolValueIndex.Find(type, value))
+            return *indices | std::views::transform([this](uint32 index) { return GetByIndex(index); }) | std::ranges::to<std::vector>();
+        return { };
+    }
+
+    // Rebuilds stale cached display names in the background whenever something they might have been built from changed
+    void UpdateDisplayNames()
+    {
+        if (!m_loaded || m_displayNamesUpdate.IsRunning())
+            return;
+
+        if (auto const stamp = DisplayNameCache::GetStamp(); stamp != m_displayNamesStamp)
+        {
+            m_displayNamesStamp = stamp;
+            m_displayNamesUpdate.Run([this](Utils::Async::ProgressBarContext& progress) { DisplayNameCache::RefreshStale(GetObjects(), progress); });
+        }
+    }
+
 private:
     bool m_loaded = false;
     uint32 m_firstContentFileID = 1282830;
@@ -195,11 +300,34 @@ private:
     std::vector<ContentObject*> m_rootedObjects;
     std::vector<ContentObject*> m_unrootedObjects;
     std::unordered_map<byte const*, ContentObject*> m_objectsByDataPointer;
-    std::unordered_map<GUID, ContentObject*> m_objectsByGUID;
+    Utils::Container::OpenAddressingMap<GUID, ContentObject*> m_objectsByGUID;
+    struct TypeObjectLookup
+    {
+        Utils::Container::OpenAddressingMap<uint32, ContentObject const*> ByDataID;
+    };
+    std::vector<TypeObjectLookup> m_objectsByTypeID;
 
-    std::unordered_map<std::wstring_view, std::vector<ContentObject*>> m_objectsByName;
+    Utils::Container::OpenAddressingMap<std::wstring_view, std::vector<ContentObject*>> m_objectsByName;
     std::unordered_map<std::wstring_view, std::vector<ContentNamespace*>> m_namespacesByName;
 
+    // Sorted by file ID and then by object index
+    std::vector<uint32> m_fileReferenceIDs;
+    std::vector<uint32> m_fileReferenceObjects;
+
+    NameIndex m_nameIndex;
+    std::mutex m_nameIndexUpdateMutex;
+    Utils::Async::ProgressBarContext m_nameIndexUpdate;
+
+    SymbolValueIndex m_symbolValueIndex;
+    std::mutex m_symbolValueIndexUpdateMutex;
+    Utils::Async::ProgressBarContext m_symbolValueIndexUpdate;
+
+    size_t m_displayNamesStamp = 0;
+    Utils::Async::ProgressBarContext m_displayNamesUpdate;
+
+    std::vector<uint32> m_encryptedContentFiles; // Indices of the read content files that are still waiting for their decryption keys
+    mutable std::mutex m_encryptedContentFilesMutex;
+
     [[nodiscard]] ContentNamespace* GetNamespaceMutable(uint32 index) const { return m_namespaces.at(index); }
     [[nodiscard]] ContentObject* GetByDataPointerMutable(byte const* ptr) const { if (auto const object = Utils::Container::Find(m_objectsByDataPointer, ptr)) return *object; return nullptr; }
 
@@ -211,19 +339,551 @@ private:
     struct LoadedContentFile
     {
         std::unique_ptr<Pack::PackFile> File;
-        std::set<size_t> EntryBoundaries;
-        std::unique_ptr<byte[]> UsedContentByteMap;
+        uint32 CRC = 0;
+        std::vector<uint32> EntryBoundaries;
+        ContentByteMap UsedContentByteMap;
         std::vector<std::unique_ptr<ContentTypeInfo>> Types;
         std::vector<std::unique_ptr<ContentNamespace>> Namespaces;
         std::vector<std::unique_ptr<ContentObject>> Objects;
     };
     std::vector<LoadedContentFile> m_loadedContentFiles;
+    bool ReadContentFiles(Utils::Async::ProgressBarContext& progress);
+    bool DecryptContentFiles(std::vector<uint32>&& indices, Utils::Async::ProgressBarContext& progress);
+    [[nodiscard]] bool HasAnyContentFileKey(std::span<uint32 const> indices) const;
+    [[nodiscard]] std::string FormatContentFileList(std::span<uint32 const> indices) const;
     enum class PostProcessStage
     {
         GatherContentPointers,
         ProcessFixupsAndCreateObjects,
         ProcessTrackedReferences,
     };
+    // Reference implementation, processes the content files one at a time in file order
+    void ProcessSerial(Utils::Async::ProgressBarContext& progress)
+    {
+        std::array<std::tuple<PostProcessStage, char const*>, 3> STAGES
+        { {
+            { PostProcessStage::GatherContentPointers, "Marking content pointers" },
+            { PostProcessStage::ProcessFixupsAndCreateObjects, "Processing content files" },
+            { PostProcessStage::ProcessTrackedReferences, "Processing tracked references" },
+        } };
+        for (auto const& [stage, description] : STAGES)
+        {
+            progress.Start(description, m_loadedContentFiles.size());
+            for (auto& loaded : m_loadedContentFiles)
+            {
+                PostProcessContentFile(loaded, stage);
+                ++progress;
+            }
+            if (stage == PostProcessStage::GatherContentPointers)
+                BuildContentDataPointers();
+            else if (stage == PostProcessStage::ProcessFixupsAndCreateObjects)
+            {
+                BuildObjectLookups();
+                BuildObjectEntries();
+            }
+        }
+        assert(GetNamespaceRoot());
+
+        m_loadedObjects = true;
+
+        m_references.Build(std::exchange(m_pendingReferences, { }));
+        progress.Start("Processing all references", m_references.size());
+        for (auto const& [index, source] : m_references.Sources | std::views::enumerate)
+        {
+            auto const* sourceObject = GetByDataPointerMutable(source);
+            for (auto const& target : m_references.GetTargets(index))
+                m_pendingObjectReferences.emplace_back(sourceObject->Index, GetByDataPointerMutable(target)->Index, ContentObject::Reference::Types::All);
+            ++progress;
+        }
+        BuildObjectReferences();
+    }
+    // RC4 has no integrity check, but the relocation slots of a decrypted file hold offsets into its own content and indices into its own string table,
+    // which data decrypted with the wrong key practically never does
+    [[nodiscard]] static bool IsDecryptedContentValid(std::span<byte const> data, std::ranges::range auto&& localOffsets, std::ranges::range auto&& stringIndices, size_t numStrings)
+    {
+        auto slotsBelow = [data](std::ranges::range auto&& relocOffsets, size_t limit)
+        {
+            return std::ranges::all_of(relocOffsets, [data, limit](uint32 relocOffset)
+            {
+                return data.size() >= sizeof(size_t) && relocOffset <= data.size() - sizeof(size_t) && *(size_t const*)&data[relocOffset] < limit;
+            });
+        };
+        return slotsBelow(localOffsets, data.size() + 1) && slotsBelow(stringIndices, numStrings);
+    }
+#ifdef NATIVE
+    [[nodiscard]] static PackContent& GetRawContent(LoadedContentFile const& loaded)
+    {
+        auto& file = *loaded.File;
+        assert(file.Header.HeaderSize == sizeof(file.Header));
+        auto& chunk = file.GetFirstChunk();
+        assert(chunk.Header.HeaderSize == sizeof(chunk.Header));
+        return (PackContent&)chunk.Data;
+    }
+    [[nodiscard]] static PackContent& GetContent(LoadedContentFile const& loaded)
+    {
+        auto& content = GetRawContent(loaded);
+        assert(!(content.flags & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED)); // Decrypted by DecryptContentFiles() before processing
+        return content;
+    }
+    [[nodiscard]] static bool IsContentFileEncrypted(LoadedContentFile const& loaded) { return GetRawContent(loaded).flags & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED; }
+    // Only the content data is encrypted, the fixup tables around it aren't. It's decrypted into a copy first, so that the file stays encrypted if the key is wrong
+    static void DecryptContentFile(LoadedContentFile const& loaded, uint64 key)
+    {
+        auto& content = GetRawContent(loaded);
+        if (!(content.flags & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED))
+            return;
+
+        std::vector<byte> decrypted(content.content.data(), content.content.data() + content.content.size());
+        Encryption::RC4(Encryption::RC4::MakeKey(key)).Crypt(decrypted);
+        if (!IsDecryptedContentValid(decrypted, content.localOffsets | std::views::transform(&PackContentLocalOffsetFixup::relocOffset), content.stringIndices | std::views::transform(&PackContentStringIndexFixup::relocOffset), content.strings.size()))
+            return;
+
+        std::ranges::copy(decrypted, content.content.data());
+        content.flags &= ~GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED;
+    }
+    void ForEachContentFile(Utils::Async::ProgressBarContext& progress, char const* description, std::function<void(LoadedContentFile& loaded, PackContent const& content, size_t index)> const& func)
+    {
+        std::atomic<size_t> processed = 0;
+        progress.Start(description, m_loadedContentFiles.size());
+        std::for_each(std::execution::par, m_loadedContentFiles.begin(), m_loadedContentFiles.end(), [&](LoadedContentFile& loaded)
+        {
+            func(loaded, GetContent(loaded), std::distance(m_loadedContentFiles.data(), &loaded));
+            progress = ++processed;
+        });
+    }
+    // Only writes into the file's own content, addReference is called with every relocated pointer slot that might point at a content entry
+    void RelocateContentFile(LoadedContentFile& loaded, PackContent const& content, auto&& addReference)
+    {
+        auto const& data = content.content;
+        auto& byteMap = loaded.UsedContentByteMap = { };
+        byteMap.Reserve(content.localOffsets.size() + content.externalOffsets.size() + content.fileIndices.size() + content.stringIndices.size());
+
+        for (auto const& [relocOffset] : content.localOffsets)
+        {
+            *(byte**)&data[relocOffset] += (size_t)data.data();
+            byteMap.Mark(relocOffset, ContentByteMap::Kinds::LocalOffset);
+            addReference(*(byte**)&data[relocOffset]);
+        }
+        for (auto const& [relocOffset, targetFileIndex] : content.externalOffsets)
+        {
+            *(byte**)&data[relocOffset] = &GetContent(m_loadedContentFiles.at(targetFileIndex)).content[*(size_t*)&data[relocOffset]];
+            byteMap.Mark(relocOffset, ContentByteMap::Kinds::ExternalOffset);
+            addReference(*(byte**)&data[relocOffset]);
+        }
+        for (auto const& fileRefs = m_rootContentFile->fileRefs; auto const& [relocOffset] : content.fileIndices)
+        {
+            *(byte**)&data[relocOffset] = (byte*)((Pack::FileReference)fileRefs[*(size_t*)&data[relocOffset]]).GetFileID();
+            byteMap.Mark(relocOffset, ContentByteMap::Kinds::File);
+        }
+        for (auto const& strings = content.strings; auto const& [relocOffset] : content.stringIndices)
+        {
+            *(byte**)&data[relocOffset] = (byte*)((std::wstring_view)strings[*(size_t*)&data[relocOffset]]).data();
+            byteMap.Mark(relocOffset, ContentByteMap::Kinds::String);
+        }
+        byteMap.Finish();
+    }
+    // Object indices are assigned up front from the entry counts, roots always live in the same file as their entries
+    [[nodiscard]] std::vector<uint32> GetFirstObjectIndices() const
+    {
+        std::vector<uint32> firstObjectIndex(m_loadedContentFiles.size() + 1, (uint32)m_objects.size());
+        for (auto const& [index, loaded] : m_loadedContentFiles | std::views::enumerate)
+            firstObjectIndex[index + 1] = firstObjectIndex[index] + (uint32)GetContent(loaded).indexEntries.size();
+        return firstObjectIndex;
+    }
+    // Each shared container is filled by a single task walking the objects in index order
+    void MergeObjects()
+    {
+        auto const objects = m_loadedContentFiles | std::views::transform(&LoadedContentFile::Objects) | std::views::join;
+        size_t const numObjects = std::ranges::fold_left(m_loadedContentFiles | std::views::transform([](LoadedContentFile const& loaded) { return loaded.Objects.size(); }), (size_t)0, std::plus());
+        std::array<std::function<void()>, 4> merges
+        { {
+            [&]
+            {
+                m_objects.reserve(m_objects.size() + numObjects);
+                m_rootedObjects.reserve(m_rootedObjects.size() + numObjects);
+                m_unrootedObjects.reserve(m_unrootedObjects.size() + numObjects);
+                for (auto const& object : objects)
+                {
+                    m_objects.emplace_back(object.get());
+                    m_typeInfos.at(object->Type->Index)->Objects.emplace_back(object.get());
+                    if (object->Root)
+                        m_rootedObjects.emplace_back(object.get());
+                    else
+                    {
+                        GetNamespaceMutable(object->Namespace->Index)->Entries.emplace_back(object.get());
+                        m_unrootedObjects.emplace_back(object.get());
+                    }
+                }
+            },
+            [&]
+            {
+                m_objectsByDataPointer.reserve(m_objectsByDataPointer.size() + numObjects);
+                for (auto const& object : objects)
+                    assert(m_objectsByDataPointer.emplace(object->Data.data(), object.get()).second);
+            },
+            [&]
+            {
+                m_objectsByGUID.reserve(m_objectsByGUID.size() + numObjects);
+                for (auto const& object : objects)
+                    if (auto const guid = object->GetGUID(); guid && !m_objectsByGUID.emplace(*guid, object.get()).second)
+                        std::terminate();
+            },
+            [&]
+            {
+                m_objectsByName.reserve(m_objectsByName.size() + numObjects);
+                for (auto const& object : objects)
+                {
+                    if (auto const names = object->GetName(); names && names->FullName && *names->FullName && **names->FullName)
+                    {
+                        std::wstring_view name = *names->FullName;
+                        if (auto const pos = name.find_last_of(L'.'); pos != std::wstring_view::npos)
+                            name.remove_prefix(pos + 1);
+                        m_objectsByName[name].emplace_back(object.get());
+                    }
+                }
+            },
+        } };
+        std::for_each(std::execution::par, merges.begin(), merges.end(), [](auto const& merge) { merge(); });
+        BuildObjectLookups();
+        BuildObjectEntries();
+    }
+
+    // Runs every stage over all content files at once. Work that only touches a file's own data and objects is done in place, anything
+    // that ends up in shared containers is staged per file and merged in file order, so the resulting graph matches ProcessSerial()
+    void ProcessParallel(Utils::Async::ProgressBarContext& progress)
+    {
+        auto const numFiles = m_loadedContentFiles.size();
+        std::vector<std::vector<PendingObjectReference>> staged(numFiles);
+        m_rootContentFile = &GetContent(m_loadedContentFiles.front());
+
+        {
+            std::vector<std::vector<byte const*>> pointers(numFiles);
+            ForEachContentFile(progress, "Marking content pointers", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+            {
+                pointers[index].reserve(content.indexEntries.size());
+                for (auto const& entry : content.indexEntries)
+                    pointers[index].emplace_back(&content.content[entry.offset]);
+            });
+            m_contentDataPointers.append_range(pointers | std::views::join);
+            BuildContentDataPointers();
+        }
+
+        {
+            std::vector<std::vector<std::pair<byte const*, byte const*>>> references(numFiles);
+            ForEachContentFile(progress, "Processing content files", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+            {
+                RelocateContentFile(loaded, content, [&](byte const* const& target)
+                {
+                    if (auto const source = FindReferenceSource(target))
+                        references[index].emplace_back(source, target);
+                });
+            });
+            m_pendingReferences.append_range(references | std::views::join);
+            m_references.Build(std::exchange(m_pendingReferences, { }));
+        }
+
+        for (auto& loaded : m_loadedContentFiles)
+            CreateTypesAndNamespaces(loaded, GetContent(loaded));
+
+        auto const firstObjectIndex = GetFirstObjectIndices();
+        ForEachContentFile(progress, "Creating content objects", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+        {
+            auto const& data = content.content;
+            auto const& indexEntries = content.indexEntries;
+            if (indexEntries.empty())
+                return;
+
+            loaded.Objects.reserve(indexEntries.size());
+            loaded.EntryBoundaries.reserve(indexEntries.size() + 1);
+            loaded.EntryBoundaries.emplace_back(data.size());
+            for (auto const& entry : indexEntries)
+                loaded.EntryBoundaries.emplace_back(entry.offset);
+            Utils::Container::SortAndDeduplicate(loaded.EntryBoundaries);
+
+            for (auto const& [entryIndex, entry] : indexEntries | std::views::enumerate)
+            {
+                auto const& [type, offset, namespaceIndex, rootIndex] = entry;
+                // Serial processing only finds roots that were created before their entries
+                auto* root = rootIndex >= 0 && rootIndex < entryIndex ? loaded.Objects[rootIndex].get() : nullptr;
+                auto object = new ContentObject
+                {
+                    .Index = firstObjectIndex[index] + (uint32)entryIndex,
+                    .Type = m_typeInfos.at(type),
+                    .Namespace = GetNamespaceMutable(namespaceIndex),
+                    .Root = root,
+                    .Data = { &data[offset], ContentObject::UNINITIALIZED_SIZE },
+                    .ContentFileEntryOffset = offset,
+                    .ContentFileEntryBoundaries = &loaded.EntryBoundaries,
+                    .ByteMap = &loaded.UsedContentByteMap,
+                };
+                loaded.Objects.emplace_back(object);
+                if (root)
+                    staged[index].emplace_back(root->Index, object->Index, ContentObject::Reference::Types::Root);
+            }
+        });
+
+        MergeObjects();
+
+        ForEachContentFile(progress, "Processing tracked references", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+        {
+            for (auto const& [sourceOffset, targetFileIndex, targetOffset] : content.trackedReferences)
+            {
+                auto const* source = GetByDataPointerMutable(&content.content[sourceOffset]);
+                auto const* target = GetByDataPointerMutable(&GetContent(m_loadedContentFiles[targetFileIndex]).content[targetOffset]);
+                staged[index].emplace_back(source->Index, target->Index, ContentObject::Reference::Types::Tracked);
+            }
+        });
+        assert(GetNamespaceRoot());
+
+        m_loadedObjects = true;
+
+        // Every source owns the slice of m_references that holds its targets, so the resolved references can be written in place
+        std::vector<PendingObjectReference> all(m_references.Targets.size());
+        std::atomic<size_t> processed = 0;
+        progress.Start("Processing all references", m_references.size());
+        std::for_each(std::execution::par, m_references.Sources.begin(), m_references.Sources.end(), [&](byte const* const& source)
+        {
+            auto const index = std::distance(m_references.Sources.data(), &source);
+            auto const sourceIndex = GetByDataPointerMutable(source)->Index;
+            for (auto const& [offset, target] : m_references.GetTargets(index) | std::views::enumerate)
+                all[m_references.Offsets[index] + offset] = PendingObjectReference { sourceIndex, GetByDataPointerMutable(target)->Index, ContentObject::Reference::Types::All };
+            if (auto const done = ++processed; !(done % 1024))
+                progress = done;
+        });
+        progress = m_references.size();
+
+        m_pendingObjectReferences.reserve(all.size() + std::ranges::fold_left(staged | std::views::transform([](auto const& references) { return references.size(); }), (size_t)0, std::plus()));
+        m_pendingObjectReferences.append_range(staged | std::views::join);
+        m_pendingObjectReferences.append_range(all);
+        BuildObjectReferences();
+    }
+
+    // Every file ID in the content was written by a file index fixup, so they can all be found without knowing the struct layouts
+    void BuildFileReferences(Utils::Async::ProgressBarContext& progress)
+    {
+        std::vector<std::vector<std::pair<uint32, uint32>>> references(m_loadedContentFiles.size());
+        ForEachContentFile(progress, "Indexing file references", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+        {
+            auto const& data = content.content;
+            auto const& boundaries = loaded.EntryBoundaries;
+            references[index].reserve(content.fileIndices.size());
+            for (auto const& [relocOffset] : content.fileIndices)
+            {
+                // The innermost entry starting at or before the fixup owns it, same as when the entry's size is determined
+                auto const itr = std::ranges::upper_bound(boundaries, relocOffset);
+                if (itr == boundaries.begin())
+                    continue;
+                if (auto const object = GetByDataPointerMutable(&data[*std::prev(itr)]))
+                    references[index].emplace_back(*(uint32 const*)&data[relocOffset], object->Index);
+            }
+        });
+
+        auto merged = references | std::views::join | std::ranges::to<std::vector>();
+        std::sort(std::execution::par, merged.begin(), merged.end());
+        merged.erase(std::unique(std::execution::par, merged.begin(), merged.end()), merged.end());
+        m_fileReferenceIDs = merged | std::views::keys | std::ranges::to<std::vector>();
+        m_fileReferenceObjects = merged | std::views::values | std::ranges::to<std::vector>();
+    }
+
+    // Changes whenever the record layouts or the content type table they index into change
+    [[nodiscard]] uint64 GetSnapshotLayoutHash() const
+    {
+        static constexpr std::array<uint32, 6> sizes { sizeof(PackContent), sizeof(PackContentIndexEntry), sizeof(ContentSnapshotFile), sizeof(ContentSnapshotObject), sizeof(ContentSnapshotReference), sizeof(ContentObject::Reference) };
+        auto const& typeInfos = m_rootContentFile->typeInfos;
+        return (uint64)Utils::CRC::Calculate(0, { (byte const*)sizes.data(), sizeof(sizes) }) << 32 | Utils::CRC::Calculate(0, { (byte const*)typeInfos.data(), typeInfos.size() * sizeof(PackContentTypeInfo) });
+    }
+    // Restores the graph saved by SaveSnapshot() if it was built from the same content files, only the relocations are reapplied
+    bool LoadSnapshot(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress)
+    {
+        if (!exists(path) || m_loadedContentFiles.empty() || !m_objects.empty())
+            return false;
+
+        std::error_code error;
+        mio::mmap_source file;
+        file.map(path.wstring(), error);
+        if (error || file.size() < sizeof(ContentSnapshotHeader))
+            return false;
+
+        auto const& header = *(ContentSnapshotHeader const*)file.data();
+        if (header.FourCC != ContentSnapshotHeader().FourCC || header.FourCC2 != ContentSnapshotHeader().FourCC2 || header.Version != ContentSnapshotHeader::CurrentVersion)
+            return false;
+        if (header.NumFiles != m_loadedContentFiles.size())
+            return false;
+        if (file.size() != sizeof(ContentSnapshotHeader) + header.NumFiles * sizeof(ContentSnapshotFile) + header.NumBoundaries * sizeof(uint32) + header.NumObjects * sizeof(ContentSnapshotObject) + ((size_t)header.NumOutgoingReferences + header.NumIncomingReferences) * sizeof(ContentSnapshotReference) + header.NumFileReferences * 2 * sizeof(uint32))
+            return false;
+
+        auto const files = std::span((ContentSnapshotFile const*)(file.data() + sizeof(ContentSnapshotHeader)), header.NumFiles);
+        auto const boundaries = (uint32 const*)std::to_address(files.end());
+        auto const objects = std::span((ContentSnapshotObject const*)(boundaries + header.NumBoundaries), header.NumObjects);
+        auto const outgoing = (ContentSnapshotReference const*)std::to_address(objects.end());
+        auto const incoming = outgoing + header.NumOutgoingReferences;
+        auto const fileReferenceIDs = (uint32 const*)(incoming + header.NumIncomingReferences);
+        auto const fileReferenceObjects = fileReferenceIDs + header.NumFileReferences;
+
+        for (auto const& [loaded, snapshot] : std::views::zip(m_loadedContentFiles, files))
+            if (!loaded.File || loaded.CRC != snapshot.CRC || GetContent(loaded).indexEntries.size() != snapshot.NumObjects)
+                return false;
+
+        m_rootContentFile = &GetContent(m_loadedContentFiles.front());
+        if (header.LayoutHash != GetSnapshotLayoutHash())
+            return false;
+
+        // Relocating modifies the content files, so a corrupt snapshot has to be rejected before then for the graph to be rebuilt from them instead
+        auto const firstObjectIndex = GetFirstObjectIndices();
+        if (firstObjectIndex.back() != header.NumObjects || std::ranges::fold_left(files | std::views::transform(&ContentSnapshotFile::NumBoundaries), (size_t)0, std::plus()) != header.NumBoundaries)
+            return false;
+        size_t numTypes = m_typeInfos.size();
+        size_t numNamespaces = m_namespaces.size();
+        for (auto const& loaded : m_loadedContentFiles)
+        {
+            numTypes += GetContent(loaded).typeInfos.size();
+            numNamespaces += GetContent(loaded).namespaces.size();
+        }
+        std::vector<uint32> firstBoundary(files.size() + 1);
+        for (auto const& [index, snapshot] : files | std::views::enumerate)
+            firstBoundary[index + 1] = firstBoundary[index] + snapshot.NumBoundaries;
+        for (auto const& [index, loaded] : m_loadedContentFiles | std::views::enumerate)
+        {
+            // Boundaries are the sorted, unique entry offsets of the file followed by its size, the same as when processing the file
+            auto const dataSize = GetContent(loaded).content.size();
+            auto const fileBoundaries = std::span(boundaries + firstBoundary[index], files[index].NumBoundaries);
+            if (fileBoundaries.empty() || fileBoundaries.back() != dataSize || std::ranges::adjacent_find(fileBoundaries, std::greater_equal()) != fileBoundaries.end())
+                return false;
+            for (auto const& [entryIndex, record] : objects.subspan(firstObjectIndex[index], files[index].NumObjects) | std::views::enumerate)
+                if (record.Type >= numTypes || record.Namespace >= numNamespaces || record.Offset >= dataSize
+                    || record.Root >= 0 && ((uint32)record.Root < firstObjectIndex[index] || (uint32)record.Root >= firstObjectIndex[index] + entryIndex))
+                    return false;
+        }
+        auto isReferenceTable = [&objects](std::span<ContentSnapshotReference const> records, uint32 ContentSnapshotObject::* first)
+        {
+            return std::ranges::is_sorted(objects, std::less(), first)
+                && (objects.empty() || objects.back().*first <= records.size())
+                && std::ranges::all_of(records, [&objects](ContentSnapshotReference const& record) { return record.Object < objects.size(); });
+        };
+        if (!isReferenceTable({ outgoing, header.NumOutgoingReferences }, &ContentSnapshotObject::FirstOutgoingReference)
+            || !isReferenceTable({ incoming, header.NumIncomingReferences }, &ContentSnapshotObject::FirstIncomingReference)
+            || !std::all_of(fileReferenceObjects, fileReferenceObjects + header.NumFileReferences, [&objects](uint32 index) { return index < objects.size(); }))
+            return false;
+
+        ForEachContentFile(progress, "Processing content files", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+        {
+            RelocateContentFile(loaded, content, [](byte const* const&) { });
+        });
+
+        for (auto& loaded : m_loadedContentFiles)
+            CreateTypesAndNamespaces(loaded, GetContent(loaded));
+
+        ForEachContentFile(progress, "Restoring content objects", [&](LoadedContentFile& loaded, PackContent const& content, size_t index)
+        {
+            auto const& data = content.content;
+            loaded.EntryBoundaries.assign(boundaries + firstBoundary[index], boundaries + firstBoundary[index + 1]);
+            loaded.Objects.reserve(files[index].NumObjects);
+            for (auto const& record : objects.subspan(firstObjectIndex[index], files[index].NumObjects))
+            {
+                auto* root = record.Root >= 0 ? loaded.Objects.at(record.Root - firstObjectIndex[index]).get() : nullptr;
+                auto object = new ContentObject
+                {
+                    .Index = firstObjectIndex[index] + (uint32)loaded.Objects.size(),
+                    .Type = m_typeInfos.at(record.Type),
+                    .Namespace = GetNamespaceMutable(record.Namespace),
+                    .Root = root,
+                    .Data = { &data[record.Offset], ContentObject::UNINITIALIZED_SIZE },
+                    .ContentFileEntryOffset = record.Offset,
+                    .ContentFileEntryBoundaries = &loaded.EntryBoundaries,
+                    .ByteMap = &loaded.UsedContentByteMap,
+                };
+                loaded.Objects.emplace_back(object);
+            }
+        });
+
+        MergeObjects();
+
+        progress.Start("Restoring content references");
+        auto const restore = [&](std::span<ContentSnapshotReference const> records, uint32 ContentSnapshotObject::* first, ObjectTable<ContentObject::Reference>& table)
+        {
+            table.Offsets.resize(objects.size() + 1);
+            std::ranges::transform(objects, table.Offsets.begin(), [first](ContentSnapshotObject const& record) { return record.*first; });
+            table.Offsets.back() = (uint32)records.size();
+            table.Values.resize(records.size());
+            std::transform(std::execution::par, records.begin(), records.end(), table.Values.begin(), [this](ContentSnapshotReference const& record)
+            {
+                return ContentObject::Reference { m_objects.at(record.Object), (ContentObject::Reference::Types)record.Type };
+            });
+        };
+        restore({ outgoing, header.NumOutgoingReferences }, &ContentSnapshotObject::FirstOutgoingReference, m_outgoingReferences);
+        restore({ incoming, header.NumIncomingReferences }, &ContentSnapshotObject::FirstIncomingReference, m_incomingReferences);
+        AssignObjectReferences();
+        assert(GetNamespaceRoot());
+
+        m_fileReferenceIDs.assign(fileReferenceIDs, fileReferenceIDs + header.NumFileReferences);
+        m_fileReferenceObjects.assign(fileReferenceObjects, fileReferenceObjects + header.NumFileReferences);
+
+        m_loadedObjects = true;
+        return true;
+    }
+    void SaveSnapshot(std::filesystem::path const& path) const
+    {
+        std::vector<ContentSnapshotFile> files;
+        std::vector<uint32> boundaries;
+        for (auto const& loaded : m_loadedContentFiles)
+        {
+            files.emplace_back(loaded.CRC, (uint32)loaded.EntryBoundaries.size(), (uint32)loaded.Objects.size());
+            boundaries.append_range(loaded.EntryBoundaries);
+        }
+
+        std::vector<ContentSnapshotObject> objects;
+        std::vector<ContentSnapshotReference> outgoing, incoming;
+        objects.reserve(m_objects.size());
+        for (auto const object : m_objects)
+        {
+            objects.emplace_back(object->Type->Index, object->Namespace->Index, object->Root ? (int32)object->Root->Index : -1, object->ContentFileEntryOffset, (uint32)outgoing.size(), (uint32)incoming.size());
+            for (auto const& [target, type] : object->OutgoingReferences)
+                outgoing.emplace_back(target->Index, (uint32)type);
+            for (auto const& [source, type] : object->IncomingReferences)
+                incoming.emplace_back(source->Index, (uint32)type);
+        }
+
+        ContentSnapshotHeader const header
+        {
+            .NumFiles = (uint32)files.size(),
+            .LayoutHash = GetSnapshotLayoutHash(),
+            .NumBoundaries = (uint32)boundaries.size(),
+            .NumObjects = (uint32)objects.size(),
+            .NumOutgoingReferences = (uint32)outgoing.size(),
+            .NumIncomingReferences = (uint32)incoming.size(),
+            .NumFileReferences = (uint32)m_fileReferenceIDs.size(),
+        };
+        std::ofstream file(path, std::ios::binary);
+        file.write((char const*)&header, sizeof(header));
+        file.write((char const*)files.data(), files.size() * sizeof(ContentSnapshotFile));
+        file.write((char const*)boundaries.data(), boundaries.size() * sizeof(uint32));
+        file.write((char const*)objects.data(), objects.size() * sizeof(ContentSnapshotObject));
+        file.write((char const*)outgoing.data(), outgoing.size() * sizeof(ContentSnapshotReference));
+        file.write((char const*)incoming.data(), incoming.size() * sizeof(ContentSnapshotReference));
+        file.write((char const*)m_fileReferenceIDs.data(), m_fileReferenceIDs.size() * sizeof(uint32));
+        file.write((char const*)m_fileReferenceObjects.data(), m_fileReferenceObjects.size() * sizeof(uint32));
+    }
+#else
+    bool LoadSnapshot(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress) { return false; }
+    void SaveSnapshot(std::filesystem::path const& path) const { }
+    [[nodiscard]] static bool IsContentFileEncrypted(LoadedContentFile const& loaded) { return (uint32)loaded.File->QueryChunk(fcc::Main)["flags"] & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED; }
+    static void DecryptContentFile(LoadedContentFile const& loaded, uint64 key)
+    {
+        auto const content = loaded.File->QueryChunk(fcc::Main);
+        auto& flags = *(uint32*)&content["flags"];
+        if (!(flags & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED))
+            return;
+
+        auto const data = content["content[]"];
+        std::vector<byte> decrypted(data.data(), data.data() + data.size());
+        Encryption::RC4(Encryption::RC4::MakeKey(key)).Crypt(decrypted);
+        if (!IsDecryptedContentValid(decrypted, content["localOffsets"] | fields<"relocOffset"> | std::views::elements<0>, content["stringIndices"] | fields<"relocOffset"> | std::views::elements<0>, content["strings"].size()))
+            return;
+
+        std::ranges::copy(decrypted, (byte*)data.data());
+        flags &= ~GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED;
+    }
+#endif
     void PostProcessContentFile(LoadedContentFile& loaded, PostProcessStage stage)
     {
         #ifdef NATIVE
@@ -248,7 +908,7 @@ private:
         auto const data = content["content[]"];
         #endif
 
-        assert(!(contentFlags & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED)); // TODO: RC4 encrypted
+        assert(!(contentFlags & GW2Viewer::Content::CONTENT_FLAG_ENCRYPTED)); // Decrypted by DecryptContentFiles() before processing
 
         switch (stage)
         {
@@ -256,18 +916,16 @@ private:
             {
                 #ifdef NATIVE
                 for (auto const& entry : content.indexEntries)
-                    m_contentDataPointers.emplace(&data[entry.offset]);
+                    m_contentDataPointers.emplace_back(&data[entry.offset]);
                 #else
                 for (auto const& entry : content["indexEntries"])
-                    m_contentDataPointers.emplace(&data[entry["offset"]]);
+                    m_contentDataPointers.emplace_back(&data[entry["offset"]]);
                 #endif
                 break;
             }
             case PostProcessStage::ProcessFixupsAndCreateObjects:
             {
-                loaded.UsedContentByteMap = std::make_unique<byte[]>(data.size());
-                byte* usedBytesMap = loaded.UsedContentByteMap.get();
-                memset(usedBytesMap, 0, data.size());
+                auto& byteMap = loaded.UsedContentByteMap = { };
 
                 #ifdef NATIVE
                 for (auto const& [relocOffset] : content.localOffsets)
@@ -276,7 +934,7 @@ private:
                 #endif
                 {
                     *(byte**)&data[relocOffset] += (size_t)data.data();
-                    memset(&usedBytesMap[relocOffset], 0xAA, sizeof(void*));
+                    byteMap.Mark(relocOffset, ContentByteMap::Kinds::LocalOffset);
                     AddReference(*(byte**)&data[relocOffset]);
                 }
 
@@ -291,7 +949,7 @@ private:
                     #else
                     *(byte**)&data[relocOffset] = m_loadedContentFiles.at(targetFileIndex).File->QueryChunk(fcc::Main)["content"][*(size_t*)&data[relocOffset]];
                     #endif
-                    memset(&usedBytesMap[relocOffset], 0xEE, sizeof(void*));
+                    byteMap.Mark(relocOffset, ContentByteMap::Kinds::ExternalOffset);
                     AddReference(*(byte**)&data[relocOffset]);
                 }
 
@@ -302,7 +960,7 @@ private:
                 #endif
                 {
                     *(byte**)&data[relocOffset] = (byte*)((Pack::FileReference)fileRefs[*(size_t*)&data[relocOffset]]).GetFileID();
-                    memset(&usedBytesMap[relocOffset], 0xFF, sizeof(void*));
+                    byteMap.Mark(relocOffset, ContentByteMap::Kinds::File);
                 }
 
                 #ifdef NATIVE
@@ -312,98 +970,11 @@ private:
                 #endif
                 {
                     *(byte**)&data[relocOffset] = (byte*)((std::wstring_view)strings[*(size_t*)&data[relocOffset]]).data();
-                    memset(&usedBytesMap[relocOffset], 0xBB, sizeof(void*));
+                    byteMap.Mark(relocOffset, ContentByteMap::Kinds::String);
                 }
+                byteMap.Finish();
 
-                // Read type infos (root content file only)
-                #ifdef NATIVE
-                if (auto const& typeInfos = content.typeInfos; !typeInfos.empty())
-                #else
-                if (auto const typeInfos = content["typeInfos[]"])
-                #endif
-                {
-                    loaded.Types.reserve(typeInfos.size());
-                    m_typeInfos.reserve(m_typeInfos.size() + typeInfos.size());
-                    for (auto const& typeInfo : typeInfos)
-                    {
-                        auto object = new ContentTypeInfo
-                        {
-                            .Index = (uint32)m_typeInfos.size(),
-                            #ifdef NATIVE
-                            .GUIDOffset = typeInfo.guidOffset,
-                            .UIDOffset = typeInfo.uidOffset,
-                            .DataIDOffset = typeInfo.dataIdOffset,
-                            .NameOffset = typeInfo.nameOffset,
-                            .TrackReferences = (bool)typeInfo.trackReferences,
-                            #else
-                            .GUIDOffset = typeInfo["guidOffset"],
-                            .UIDOffset = typeInfo["uidOffset"],
-                            .DataIDOffset = typeInfo["dataIdOffset"],
-                            .NameOffset = typeInfo["nameOffset"],
-                            .TrackReferences = (bool)typeInfo["trackReferences"],
-                            #endif
-                        };
-                        (void)object->GetTypeInfo(); // Ensure that it's initialized in config
-                        loaded.Types.emplace_back(object);
-                        m_typeInfos.emplace_back(object);
-                    }
-
-                    m_loadedTypes = true;
-                }
-
-                // Read namespaces (root content file only)
-                #ifdef NATIVE
-                if (auto const& namespaces = content.namespaces; !namespaces.empty())
-                #else
-                if (auto const namespaces = content["namespaces[]"])
-                #endif
-                {
-                    // Create runtime objects for namespaces
-                    loaded.Namespaces.reserve(namespaces.size());
-                    m_namespaces.reserve(m_namespaces.size() + namespaces.size());
-                    m_namespacesByName.reserve(m_namespacesByName.size() + namespaces.size());
-                    for (auto const& ns : namespaces)
-                    {
-                        auto object = new ContentNamespace
-                        {
-                            .Index = (uint32)m_namespaces.size(),
-                            #ifdef NATIVE
-                            .Domain = ns.domain,
-                            .Name = ns.name.data(),
-                            #else
-                            .Domain = ns["domain"],
-                            .Name = ns["name"],
-                            #endif
-                        };
-                        loaded.Namespaces.emplace_back(object);
-                        m_namespaces.emplace_back(object);
-                        m_namespacesByName[object->Name].emplace_back(object);
-                    }
-
-                    // Organize namespaces into a tree
-                    for (auto const& [index, ns] : namespaces | std::views::enumerate)
-                    {
-                        auto* current = GetNamespaceMutable(index);
-                        #ifdef NATIVE
-                        auto const parentIndex = ns.parentIndex;
-                        #else
-                        int32 const parentIndex = ns["parentIndex"];
-                        #endif
-                        if (parentIndex >= 0)
-                        {
-                            auto* parent = GetNamespaceMutable(parentIndex);
-                            current->Parent = parent;
-                            parent->Namespaces.emplace_back(current);
-                        }
-                        else
-                        {
-                            assert(!m_root);
-                            m_root = current;
-                        }
-                    }
-
-                    m_loadedNamespaces = true;
-                }
+                CreateTypesAndNamespaces(loaded, content);
 
                 // Read entries
                 #ifdef NATIVE
@@ -421,7 +992,7 @@ private:
                     m_objectsByName.reserve(m_objectsByName.size() + indexEntries.size());
 
                     // Determine the boundaries of each entry
-                    loaded.EntryBoundaries.emplace(data.size());
+                    loaded.EntryBoundaries.emplace_back(data.size());
                     #ifdef NATIVE
                     for (auto const& [type, offset, namespaceIndex, rootIndex] : indexEntries)
                     #else
@@ -429,8 +1000,9 @@ private:
                     #endif
                     {
                         //if (m_typeInfos.at(type)->NameOffset >= 0)
-                            loaded.EntryBoundaries.emplace(offset);
+                            loaded.EntryBoundaries.emplace_back(offset);
                     }
+                    Utils::Container::SortAndDeduplicate(loaded.EntryBoundaries);
 
                     // Read entries and add them to namespace tree
                     #ifdef NATIVE
@@ -460,7 +1032,7 @@ private:
                             .Data = { &data[offset], ContentObject::UNINITIALIZED_SIZE /*&data[*itr]*/ },
                             .ContentFileEntryOffset = offset,
                             .ContentFileEntryBoundaries = &loaded.EntryBoundaries,
-                            .ByteMap = &usedBytesMap[offset],
+                            .ByteMap = &byteMap,
                         };
                         loaded.Objects.emplace_back(object);
                         m_objects.emplace_back(object);
@@ -470,8 +1042,7 @@ private:
                         typeInfo->Objects.emplace_back(object);
                         if (root)
                         {
-                            root->Entries.emplace_back(object);
-                            root->AddReference(*object, ContentObject::Reference::Types::Root);
+                            m_pendingObjectReferences.emplace_back(root->Index, object->Index, ContentObject::Reference::Types::Root);
                             m_rootedObjects.emplace_back(object);
                         }
                         else
@@ -504,27 +1075,254 @@ private:
                     #else
                     auto const* target = &m_loadedContentFiles[targetFileIndex].File->QueryChunk(fcc::Main)["content"][targetOffset];
                     #endif
-                    GetByDataPointerMutable(source)->AddReference(*GetByDataPointerMutable(target), ContentObject::Reference::Types::Tracked);
+                    m_pendingObjectReferences.emplace_back(GetByDataPointerMutable(source)->Index, GetByDataPointerMutable(target)->Index, ContentObject::Reference::Types::Tracked);
                 }
                 break;
             }
         }
     }
 
-    std::set<byte const*> m_contentDataPointers;
-    std::map<byte const*, std::set<byte const*>> m_references;
-    void AddReference(byte const* const& target)
+    void CreateTypesAndNamespaces(LoadedContentFile& loaded, auto const& content)
     {
-        if (!m_contentDataPointers.contains(target))
-            return;
+        // Read type infos (root content file only)
+        #ifdef NATIVE
+        if (auto const& typeInfos = content.typeInfos; !typeInfos.empty())
+        #else
+        if (auto const typeInfos = content["typeInfos[]"])
+        #endif
+        {
+            loaded.Types.reserve(typeInfos.size());
+            m_typeInfos.reserve(m_typeInfos.size() + typeInfos.size());
+            for (auto const& typeInfo : typeInfos)
+            {
+                auto object = new ContentTypeInfo
+                {
+                    .Index = (uint32)m_typeInfos.size(),
+                    #ifdef NATIVE
+                    .GUIDOffset = typeInfo.guidOffset,
+                    .UIDOffset = typeInfo.uidOffset,
+                    .DataIDOffset = typeInfo.dataIdOffset,
+                    .NameOffset = typeInfo.nameOffset,
+                    .TrackReferences = (bool)typeInfo.trackReferences,
+                    #else
+                    .GUIDOffset = typeInfo["guidOffset"],
+                    .UIDOffset = typeInfo["uidOffset"],
+                    .DataIDOffset = typeInfo["dataIdOffset"],
+                    .NameOffset = typeInfo["nameOffset"],
+                    .TrackReferences = (bool)typeInfo["trackReferences"],
+                    #endif
+                };
+                (void)object->GetTypeInfo(); // Ensure that it's initialized in config
+                loaded.Types.emplace_back(object);
+                m_typeInfos.emplace_back(object);
+            }
 
-        auto current = m_contentDataPointers.lower_bound((byte const*)&target);
-        if (current == m_contentDataPointers.end())
-            current = --m_contentDataPointers.end();
+            m_loadedTypes = true;
+        }
+
+        // Read namespaces (root content file only)
+        #ifdef NATIVE
+        if (auto const& namespaces = content.namespaces; !namespaces.empty())
+        #else
+        if (auto const namespaces = content["namespaces[]"])
+        #endif
+        {
+            // Create runtime objects for namespaces
+            loaded.Namespaces.reserve(namespaces.size());
+            m_namespaces.reserve(m_namespaces.size() + namespaces.size());
+            m_namespacesByName.reserve(m_namespacesByName.size() + namespaces.size());
+            for (auto const& ns : namespaces)
+            {
+                auto object = new ContentNamespace
+                {
+                    .Index = (uint32)m_namespaces.size(),
+                    #ifdef NATIVE
+                    .Domain = ns.domain,
+                    .Name = ns.name.data(),
+                    #else
+                    .Domain = ns["domain"],
+                    .Name = ns["name"],
+                    #endif
+                };
+                loaded.Namespaces.emplace_back(object);
+                m_namespaces.emplace_back(object);
+                m_namespacesByName[object->Name].emplace_back(object);
+            }
+
+            // Organize namespaces into a tree
+            for (auto const& [index, ns] : namespaces | std::views::enumerate)
+            {
+                auto* current = GetNamespaceMutable(index);
+                #ifdef NATIVE
+                auto const parentIndex = ns.parentIndex;
+                #else
+                int32 const parentIndex = ns["parentIndex"];
+                #endif
+                if (parentIndex >= 0)
+                {
+                    auto* parent = GetNamespaceMutable(parentIndex);
+                    current->Parent = parent;
+                    parent->Namespaces.emplace_back(current);
+                }
+                else
+                {
+                    assert(!m_root);
+                    m_root = current;
+                }
+            }
+
+            m_loadedNamespaces = true;
+        }
+    }
+
+    // Content references in compressed sparse row form, the targets of Sources[i] are Targets[Offsets[i]..Offsets[i + 1]], both sorted by address
+    struct ReferenceTable
+    {
+        std::vector<byte const*> Sources;
+        std::vector<uint32> Offsets;
+        std::vector<byte const*> Targets;
+
+        [[nodiscard]] size_t size() const { return Sources.size(); }
+        [[nodiscard]] std::span<byte const* const> GetTargets(size_t index) const { return std::span(Targets).subspan(Offsets[index], Offsets[index + 1] - Offsets[index]); }
+
+        void Build(std::vector<std::pair<byte const*, byte const*>>&& references)
+        {
+            std::sort(std::execution::par, references.begin(), references.end());
+            references.erase(std::unique(references.begin(), references.end()), references.end());
+
+            Sources.clear();
+            Offsets.clear();
+            Targets.clear();
+            Targets.reserve(references.size());
+            for (auto const& [source, target] : references)
+            {
+                if (Sources.empty() || Sources.back() != source)
+                {
+                    Sources.emplace_back(source);
+                    Offsets.emplace_back((uint32)Targets.size());
+                }
+                Targets.emplace_back(target);
+            }
+            Offsets.emplace_back((uint32)Targets.size());
+            Sources.shrink_to_fit();
+            Offsets.shrink_to_fit();
+        }
+    };
+
+    // Per object lists in compressed sparse row form, the values of object i are Values[Offsets[i]..Offsets[i + 1]]
+    template<typename T>
+    struct ObjectTable
+    {
+        std::vector<uint32> Offsets;
+        std::vector<T> Values;
+
+        [[nodiscard]] std::span<T const> Get(uint32 index) const { return std::span(Values).subspan(Offsets[index], Offsets[index + 1] - Offsets[index]); }
+    };
+    ObjectTable<ContentObject const*> m_objectEntries;
+    ObjectTable<ContentObject::Reference> m_outgoingReferences;
+    ObjectTable<ContentObject::Reference> m_incomingReferences;
+    // Source index, target index, type. Collected while processing and turned into both reference tables at once by BuildObjectReferences()
+    using PendingObjectReference = std::tuple<uint32, uint32, ContentObject::Reference::Types>;
+    std::vector<PendingObjectReference> m_pendingObjectReferences;
+
+    // Entries of a root are listed in index order, which is the order they were created in
+    void BuildObjectEntries()
+    {
+        auto& [offsets, values] = m_objectEntries;
+        offsets.assign(m_objects.size() + 1, 0);
+        for (auto const object : m_objects)
+            if (object->Root)
+                ++offsets[object->Root->Index + 1];
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        values.resize(offsets.back());
+        auto next = offsets;
+        for (auto const object : m_objects)
+            if (object->Root)
+                values[next[object->Root->Index]++] = object;
+
+        for (auto const object : m_objects)
+            object->Entries = m_objectEntries.Get(object->Index);
+    }
+    void BuildObjectReferences()
+    {
+        auto const build = [this](std::vector<PendingObjectReference>& references, ObjectTable<ContentObject::Reference>& table)
+        {
+            std::sort(std::execution::par, references.begin(), references.end());
+            references.erase(std::unique(references.begin(), references.end()), references.end());
+
+            table.Offsets.assign(m_objects.size() + 1, 0);
+            for (auto const& [from, to, type] : references)
+                ++table.Offsets[from + 1];
+            std::partial_sum(table.Offsets.begin(), table.Offsets.end(), table.Offsets.begin());
+
+            table.Values.clear();
+            table.Values.reserve(references.size());
+            for (auto const& [from, to, type] : references)
+                table.Values.emplace_back(m_objects[to], type);
+        };
+
+        auto outgoing = std::exchange(m_pendingObjectReferences, { });
+        auto incoming = outgoing | std::views::transform([](PendingObjectReference const& reference)
+        {
+            auto const& [source, target, type] = reference;
+            return PendingObjectReference { target, source, type };
+        }) | std::ranges::to<std::vector>();
+        build(outgoing, m_outgoingReferences);
+        build(incoming, m_incomingReferences);
+        AssignObjectReferences();
+    }
+    void AssignObjectReferences()
+    {
+        std::for_each(std::execution::par, m_objects.begin(), m_objects.end(), [this](ContentObject* object)
+        {
+            object->OutgoingReferences = m_outgoingReferences.Get(object->Index);
+            object->IncomingReferences = m_incomingReferences.Get(object->Index);
+        });
+    }
+
+    // Built once every object has been added to its type, the first object in index order wins, same as a linear scan of the type's objects
+    void BuildObjectLookups()
+    {
+        m_objectsByTypeID.resize(m_typeInfos.size());
+        std::for_each(std::execution::par, m_typeInfos.begin(), m_typeInfos.end(), [this](ContentTypeInfo const* type)
+        {
+            auto& byDataID = m_objectsByTypeID.at(type->Index).ByDataID;
+            if (type->DataIDOffset >= 0)
+            {
+                byDataID.reserve(type->Objects.size());
+                for (auto const object : type->Objects)
+                    byDataID.emplace(*object->GetDataID(), object);
+            }
+        });
+    }
+
+    std::vector<byte const*> m_contentDataPointers;
+    std::vector<std::pair<byte const*, byte const*>> m_pendingReferences;
+    ReferenceTable m_references;
+    void BuildContentDataPointers()
+    {
+        std::sort(std::execution::par, m_contentDataPointers.begin(), m_contentDataPointers.end());
+        m_contentDataPointers.erase(std::unique(m_contentDataPointers.begin(), m_contentDataPointers.end()), m_contentDataPointers.end());
+    }
+    // Returns the content entry containing the pointer if it points at another content entry
+    [[nodiscard]] byte const* FindReferenceSource(byte const* const& target) const
+    {
+        if (!Utils::Container::BranchlessContains(m_contentDataPointers, target))
+            return nullptr;
+
+        auto current = Utils::Container::BranchlessLowerBound(m_contentDataPointers, (byte const*)&target);
+        if (current == std::to_address(m_contentDataPointers.end()))
+            --current;
         if (*current > (byte const*)&target)
             --current;
 
-        m_references[*current].emplace(target);
+        return *current;
+    }
+    void AddReference(byte const* const& target)
+    {
+        if (auto const source = FindReferenceSource(target))
+            m_pendingReferences.emplace_back(source, target);
     }
 };
 
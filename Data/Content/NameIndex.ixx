@@ -0,0 +1,138 @@
+export module GW2Viewer.Data.Content.NameIndex;
+import GW2Viewer.Common;
+import GW2Viewer.Data.Content;
+import GW2Viewer.Utils.Async.ProgressBarContext;
+import GW2Viewer.Utils.Container;
+import std;
+
+export namespace GW2Viewer::Data::Content
+{
+
+// Trigram inverted index over the upper cased names and display names of content objects. Lookups only narrow a search down
+// to candidates, which still have to be matched against their current names by the caller.
+class NameIndex
+{
+public:
+    void Build(std::span<ContentObject const* const> objects, Utils::Async::ProgressBarContext& progress)
+    {
+        auto const stamp = DisplayNameCache::GetStamp();
+
+        static constexpr size_t ChunkSize = 4096;
+        std::vector<std::vector<std::pair<Trigram, uint32>>> chunks((objects.size() + ChunkSize - 1) / ChunkSize);
+        std::atomic<size_t> processed = 0;
+        progress.Start("Indexing content names", objects.size());
+        std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](std::vector<std::pair<Trigram, uint32>>& chunk)
+        {
+            auto const begin = std::distance(chunks.data(), &chunk) * ChunkSize;
+            auto const chunkObjects = objects.subspan(begin, std::min(ChunkSize, objects.size() - begin));
+            std::vector<Trigram> trigrams;
+            for (auto const object : chunkObjects)
+            {
+                trigrams.clear();
+                if (auto const name = object->GetName(); name && name->Name && *name->Name)
+                    AddTrigrams(*name->Name, trigrams);
+                AddTrigrams(object->GetDisplayName(false, true), trigrams);
+                Utils::Container::SortAndDeduplicate(trigrams);
+                for (auto const trigram : trigrams)
+                    chunk.emplace_back(trigram, object->Index);
+            }
+            progress = processed += chunkObjects.size();
+        });
+
+        auto postings = chunks | std::views::join | std::ranges::to<std::vector>();
+        std::sort(std::execution::par, postings.begin(), postings.end());
+
+        std::vector<Trigram> trigrams;
+        std::vector<uint32> offsets;
+        std::vector<uint32> objectIndices;
+        objectIndices.reserve(postings.size());
+        for (auto const& [trigram, index] : postings)
+        {
+            if (trigrams.empty() || trigrams.back() != trigram)
+            {
+                trigrams.emplace_back(trigram);
+                offsets.emplace_back((uint32)objectIndices.size());
+            }
+            objectIndices.emplace_back(index);
+        }
+        offsets.emplace_back((uint32)objectIndices.size());
+
+        std::unique_lock _(m_mutex);
+        m_trigrams = std::move(trigrams);
+        m_offsets = std::move(offsets);
+        m_objectIndices = std::move(objectIndices);
+        m_numObjects = objects.size();
+        m_stamp = stamp;
+        m_built = true;
+    }
+
+    [[nodiscard]] bool IsBuilt() const { std::shared_lock _(m_mutex); return m_built; }
+    // Goes stale whenever anything display names are built from changes: the language, decrypted strings, custom names, display settings and layouts
+    [[nodiscard]] bool IsCurrent() const { std::shared_lock _(m_mutex); return m_built && m_stamp == DisplayNameCache::GetStamp(); }
+
+    // Returns a flag per object index that is set if the object's names might contain the search text,
+    // or nothing if the index can't narrow the search down
+    [[nodiscard]] std::optional<std::vector<bool>> GetCandidates(std::wstring_view search) const
+    {
+        std::vector<Trigram> searchTrigrams;
+        AddTrigrams(search, searchTrigrams);
+        Utils::Container::SortAndDeduplicate(searchTrigrams);
+        if (searchTrigrams.empty() || !IsCurrent())
+            return { };
+
+        std::shared_lock _(m_mutex);
+        std::vector<std::span<uint32 const>> lists;
+        for (auto const trigram : searchTrigrams)
+        {
+            auto const itr = Utils::Container::BranchlessLowerBound(m_trigrams, trigram);
+            if (itr == std::to_address(m_trigrams.end()) || *itr != trigram)
+                return std::vector<bool>(m_numObjects);
+
+            auto const index = std::distance(m_trigrams.data(), itr);
+            lists.emplace_back(std::span(m_objectIndices).subspan(m_offsets[index], m_offsets[index + 1] - m_offsets[index]));
+        }
+
+        // Intersecting from the shortest list keeps every intermediate result as small as possible
+        std::ranges::sort(lists, std::less(), [](std::span<uint32 const> list) { return list.size(); });
+        std::vector<uint32> matches { std::from_range, lists.front() };
+        std::vector<uint32> intersection;
+        for (auto const& list : lists | std::views::drop(1))
+        {
+            if (matches.empty())
+                break;
+            intersection.clear();
+            std::ranges::set_intersection(matches, list, std::back_inserter(intersection));
+            std::swap(matches, intersection);
+        }
+
+        std::vector<bool> candidates(m_numObjects);
+        for (auto const index : matches)
+            candidates[index] = true;
+        return candidates;
+    }
+
+private:
+    // Three UTF-16 code units
+    using Trigram = uint64;
+
+    static void AddTrigrams(std::wstring_view text, std::vector<Trigram>& trigrams)
+    {
+        if (text.size() < 3)
+            return;
+
+        auto normalize = [](wchar_t c) -> Trigram { return (uint16)std::towupper(c); };
+        Trigram trigram = normalize(text[0]) << 16 | normalize(text[1]);
+        for (auto const c : text | std::views::drop(2))
+            trigrams.emplace_back(trigram = (trigram << 16 | normalize(c)) & 0xFFFFFFFFFFFF);
+    }
+
+    mutable std::shared_mutex m_mutex;
+    std::vector<Trigram> m_trigrams;
+    std::vector<uint32> m_offsets;
+    std::vector<uint32> m_objectIndices;
+    size_t m_numObjects = 0;
+    size_t m_stamp = 0;
+    bool m_built = false;
+};
+
+}
@@ -0,0 +1,181 @@
+export module GW2Viewer.Data.Content.QueryBatch;
+import GW2Viewer.Common;
+import GW2Viewer.Common.JSON;
+import GW2Viewer.Data.Content;
+import GW2Viewer.Utils.Async.ProgressBarContext;
+import GW2Viewer.Utils.Encoding;
+import GW2Viewer.Utils.OrderedOutput;
+import std;
+
+export namespace GW2Viewer::Data::Content
+{
+
+// Jobs are read from a JSON array like [{ "Name": "Skills", "Types": [ "Skill" ], "Paths": [ "Icon", "Name", "Facts" ], "Format": "CSV" }].
+// Every job writes a row per object of the listed types with a column per path, holding the exported results of that path.
+struct QueryBatchJob
+{
+    enum class Formats
+    {
+        CSV,
+        NDJSON,
+    };
+
+    std::string Name;
+    std::vector<std::string> Types;
+    std::vector<std::string> Paths;
+    Formats Format = Formats::CSV;
+
+    // Names can contain anything, so characters that aren't allowed in file names, including path separators, are replaced
+    [[nodiscard]] std::string GetFileName() const
+    {
+        auto result = Name | std::views::transform([](char c) { return (byte)c < 0x20 || std::string_view(R"(<>:"/\|?*)").contains(c) ? '_' : c; }) | std::ranges::to<std::string>();
+        while (!result.empty() && (result.back() == '.' || result.back() == ' '))
+            result.pop_back();
+        return result.empty() ? "_" : result;
+    }
+};
+
+struct QueryBatchStatistics
+{
+    size_t Objects = 0;
+    size_t Results = 0;
+    std::chrono::duration<double, std::milli> Query { }; // Summed over all workers
+    std::chrono::duration<double, std::milli> Total { };
+};
+
+class QueryBatch
+{
+public:
+    [[nodiscard]] static std::optional<std::vector<QueryBatchJob>> LoadJobs(std::istream& input)
+    {
+        try
+        {
+            std::vector<QueryBatchJob> jobs;
+            for (auto const& json : ordered_json::parse(input))
+            {
+                auto& job = jobs.emplace_back(json.at("Name").get<std::string>(), json.at("Types").get<std::vector<std::string>>(), json.at("Paths").get<std::vector<std::string>>());
+                if (auto const format = json.value("Format", "CSV"); format == "NDJSON")
+                    job.Format = QueryBatchJob::Formats::NDJSON;
+                else if (format != "CSV")
+                    return { };
+            }
+            return jobs;
+        }
+        catch (...)
+        {
+            return { };
+        }
+    }
+
+    // Objects are queried in parallel batches and their rows written in type and index order, so only one batch of rows is held in memory at a time
+    static QueryBatchStatistics Run(QueryBatchJob const& job, std::span<ContentTypeInfo const* const> types, std::ostream& output, Utils::Async::ProgressBarContext& progress)
+    {
+        static ExportOptions const options { .ContentPointerFormat = ExportOptions::ContentPointerFormats::GUID };
+        auto const start = std::chrono::high_resolution_clock::now();
+
+        std::vector<ContentObject const*> objects;
+        for (auto const type : types)
+            if (std::ranges::contains(job.Types, Utils::Encoding::ToUTF8(type->GetDisplayName())))
+                objects.append_range(type->Objects);
+        auto const paths = job.Paths | std::views::transform([](std::string const& path) { return &CompileSymbolPath(path); }) | std::ranges::to<std::vector>();
+
+        if (job.Format == QueryBatchJob::Formats::CSV)
+        {
+            output << "Type,GUID,Name";
+            for (auto const& path : job.Paths)
+                output << ',' << EscapeCSV(path);
+            output << '\n';
+        }
+
+        std::atomic<size_t> results = 0;
+        std::atomic<std::chrono::nanoseconds::rep> queryTime = 0;
+        progress.Start(std::format("Running query job: {}", job.Name), objects.size());
+        Utils::OrderedOutput::ForEachBatch(std::span<ContentObject const* const>(objects), [&](ContentObject const* object, std::string& row)
+        {
+            auto const queryStart = std::chrono::high_resolution_clock::now();
+            std::vector columns(paths.size(), ordered_json::array());
+            try
+            {
+                object->Finalize();
+                for (auto const& [path, column] : std::views::zip(paths, columns))
+                {
+                    path->ForEach(*object, [&column](QuerySymbolDataResult const& result)
+                    {
+                        column.emplace_back(result.Symbol.GetType()->Export(result, options));
+                        return true;
+                    });
+                }
+            }
+            catch (...) { }
+            queryTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - queryStart).count();
+            results += std::ranges::fold_left(columns | std::views::transform(&ordered_json::size), (size_t)0, std::plus());
+
+            auto const guid = object->GetGUID();
+            if (job.Format == QueryBatchJob::Formats::CSV)
+            {
+                row = std::format("{},{},{}", EscapeCSV(Utils::Encoding::ToUTF8(object->Type->GetDisplayName())), guid ? std::format("{}", *guid) : "", EscapeCSV(Utils::Encoding::ToUTF8(object->GetFullDisplayName(false, true))));
+                for (auto const& column : columns)
+                    (row += ',') += EscapeCSV(column.empty() ? "" : column.size() == 1 && column.front().is_string() ? column.front().get<std::string>() : Utils::OrderedOutput::DumpLine(column.size() == 1 ? column.front() : column));
+            }
+            else
+            {
+                ordered_json json
+                {
+                    { "Type", Utils::Encoding::ToUTF8(object->Type->GetDisplayName()) },
+                    { "GUID", guid ? ordered_json(std::format("{}", *guid)) : ordered_json() },
+                    { "Name", Utils::Encoding::ToUTF8(object->GetFullDisplayName(false, true)) },
+                };
+                for (auto const& [path, column] : std::views::zip(job.Paths, columns))
+                    json[path] = column.empty() ? ordered_json() : column.size() == 1 ? std::move(column.front()) : std::move(column);
+                row = Utils::OrderedOutput::DumpLine(json);
+            }
+            row += '\n';
+        }, [&output](std::string const& row) { output << row; }, [&progress](size_t processed) { progress = processed; return true; });
+
+        return
+        {
+            .Objects = objects.size(),
+            .Results = results,
+            .Query = std::chrono::nanoseconds(queryTime.load()),
+            .Total = std::chrono::high_resolution_clock::now() - start,
+        };
+    }
+
+    [[nodiscard]] static std::string EscapeCSV(std::string_view text)
+    {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos)
+            return std::string(text);
+
+        std::string result = "\"";
+        for (auto const c : text)
+        {
+            if (c == '"')
+                result += '"';
+            result += c;
+        }
+        return result += '"';
+    }
+
+    // Runs every job of the file into a file of its own in directory, along with the timings of all jobs. Returns the number of jobs, or nothing if the file couldn't be loaded.
+    static std::optional<size_t> RunFile(std::filesystem::path const& jobsPath, std::filesystem::path const& directory, std::span<ContentTypeInfo const* const> types, Utils::Async::ProgressBarContext& progress)
+    {
+        std::ifstream input(jobsPath);
+        auto const jobs = LoadJobs(input);
+        if (!jobs)
+            return { };
+
+        create_directories(directory);
+        std::ofstream timings(directory / "timings.csv");
+        timings << "Job,Objects,Results,Query ms,Total ms\n";
+        for (auto const& job : *jobs)
+        {
+            std::ofstream output(directory / std::format("{}.{}", job.GetFileName(), job.Format == QueryBatchJob::Formats::CSV ? "csv" : "ndjson"));
+            auto const [objects, results, query, total] = Run(job, types, output, progress);
+            timings << std::format("{},{},{},{:.3f},{:.3f}\n", EscapeCSV(job.Name), objects, results, query.count(), total.count());
+        }
+        return jobs->size();
+    }
+    [[nodiscard]] static std::filesystem::path GetDefaultOutputDirectory(std::filesystem::path const& jobsPath, uint32 build) { return std::format(R"(Export\Game Content\queries\{}\{})", build, jobsPath.stem().string()); }
+};
+
+}
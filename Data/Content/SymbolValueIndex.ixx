@@ -0,0 +1,125 @@
+export module GW2Viewer.Data.Content.SymbolValueIndex;
+import GW2Viewer.Common;
+import GW2Viewer.Data.Content;
+import GW2Viewer.UI.Notifications;
+import GW2Viewer.Utils.Async.ProgressBarContext;
+import GW2Viewer.Utils.Container;
+import GW2Viewer.Utils.Encoding;
+import std;
+
+export namespace GW2Viewer::Data::Content
+{
+
+// Inverted index from the values of file, string and content pointer symbols to the objects that contain them. Matches the results of
+// QuerySymbolData(content, type, value), so it has to be rebuilt once struct layouts are edited.
+class SymbolValueIndex
+{
+public:
+    static constexpr std::array IndexedTypeNames { "FileID", "StringID", "Content*" };
+
+    void Build(std::span<ContentObject const* const> objects, Utils::Async::ProgressBarContext& progress)
+    {
+        auto const revision = GetLayoutRevision();
+        auto const types = IndexedTypeNames | std::views::transform(&Symbols::GetByName) | std::ranges::to<std::vector<TypeInfo::SymbolType const*>>();
+
+        struct Posting
+        {
+            TypeInfo::Condition::ValueType Value;
+            uint32 Object;
+
+            auto operator<=>(Posting const&) const = default;
+        };
+        static constexpr size_t ChunkSize = 4096;
+        std::vector<std::array<std::vector<Posting>, IndexedTypeNames.size()>> chunks((objects.size() + ChunkSize - 1) / ChunkSize);
+        std::atomic<size_t> processed = 0;
+        std::atomic<size_t> failed = 0;
+        std::string firstFailure;
+        std::mutex firstFailureMutex;
+        auto fail = [&](ContentObject const& object, std::string_view error)
+        {
+            if (failed++)
+                return;
+            std::scoped_lock _(firstFailureMutex);
+            firstFailure = std::format("{} #{}: {}", Utils::Encoding::ToUTF8(object.Type->GetDisplayName()), object.Index, error);
+        };
+        progress.Start("Indexing content symbol values", objects.size());
+        std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](std::array<std::vector<Posting>, IndexedTypeNames.size()>& chunk)
+        {
+            auto const begin = std::distance(chunks.data(), &chunk) * ChunkSize;
+            auto const chunkObjects = objects.subspan(begin, std::min(ChunkSize, objects.size() - begin));
+            for (auto const object : chunkObjects)
+            {
+                try
+                {
+                    object->Finalize();
+                    ForEachSymbolValue(*object, types, [&chunk, object](uint32 typeIndex, TypeInfo::Condition::ValueType value)
+                    {
+                        chunk[typeIndex].emplace_back(value, object->Index);
+                    });
+                }
+                catch (std::exception const& exception) { fail(*object, exception.what()); }
+                catch (...) { fail(*object, "Unknown exception"); }
+            }
+            progress = processed += chunkObjects.size();
+        });
+
+        std::array<Postings, IndexedTypeNames.size()> postings;
+        for (auto const& [typeIndex, result] : postings | std::views::enumerate)
+        {
+            auto merged = chunks | std::views::transform([typeIndex](auto const& chunk) -> auto& { return chunk[typeIndex]; }) | std::views::join | std::ranges::to<std::vector>();
+            std::sort(std::execution::par, merged.begin(), merged.end());
+            merged.erase(std::unique(std::execution::par, merged.begin(), merged.end()), merged.end());
+            result.Values = merged | std::views::transform(&Posting::Value) | std::ranges::to<std::vector>();
+            result.Objects = merged | std::views::transform(&Posting::Object) | std::ranges::to<std::vector>();
+        }
+
+        // Objects that couldn't be indexed would be missing from the results, so queries fall back to scanning until layouts are edited again
+        if (failed)
+            G::Notifications.AddCloseable({ .Text = std::format("Failed to index content symbol values of {} objects, searches will scan all content instead.\nFirst failure in {}", failed.load(), firstFailure) });
+
+        std::unique_lock _(m_mutex);
+        m_types = types;
+        m_postings = std::move(postings);
+        m_revision = revision;
+        m_built = true;
+        m_valid = !failed;
+    }
+
+    [[nodiscard]] bool IsBuilt() const { std::shared_lock _(m_mutex); return m_built; }
+    [[nodiscard]] bool IsCurrent() const { std::shared_lock _(m_mutex); return m_built && m_revision == GetLayoutRevision(); }
+
+    // Indices of the objects containing a symbol of the given type with the given value in ascending order,
+    // or nothing if the type isn't indexed, the index is out of date or some objects failed to be indexed
+    [[nodiscard]] std::optional<std::vector<uint32>> Find(TypeInfo::SymbolType const& type, TypeInfo::Condition::ValueType value) const
+    {
+        std::shared_lock _(m_mutex);
+        if (!m_built || !m_valid || m_revision != GetLayoutRevision())
+            return { };
+
+        auto const itr = std::ranges::find(m_types, &type);
+        if (itr == m_types.end())
+            return { };
+
+        auto const& postings = m_postings[std::distance(m_types.begin(), itr)];
+        auto const begin = std::distance(postings.Values.data(), Utils::Container::BranchlessLowerBound(postings.Values, value));
+        auto const end = std::distance(postings.Values.data(), Utils::Container::BranchlessUpperBound(postings.Values, value));
+        return std::vector(postings.Objects.begin() + begin, postings.Objects.begin() + end);
+    }
+
+private:
+    // Sorted by value and then by object index
+    struct Postings
+    {
+        std::vector<TypeInfo::Condition::ValueType> Values;
+        std::vector<uint32> Objects;
+    };
+
+    mutable std::shared_mutex m_mutex;
+    std::vector<TypeInfo::SymbolType const*> m_types;
+    std::array<Postings, IndexedTypeNames.size()> m_postings;
+    uint32 m_revision = 0;
+    bool m_built = false;
+    bool m_valid = false;
+};
+
+}
@@ -16,6 +16,7 @@ public:
     TextKeyInfo* AddTextKeyInfo(uint32 stringID, TextKeyInfo info)
     {
         //std::unique_lock _(m_lock);
+        ++m_textKeysVersion;
         return m_textKeysByOrder.emplace_back(&(m_textKeys[stringID] = std::move(info)));
     }
     [[nodiscard]] TextKeyInfo* GetTextKeyInfo(uint32 stringID)
@@ -32,6 +33,8 @@ public:
             return &itr->second;
         return nullptr;
     }
+    // Changes whenever a text key is added, which might make previously encrypted strings readable
+    [[nodiscard]] uint32 GetTextKeysVersion() const { return m_textKeysVersion; }
     [[nodiscard]] std::optional<uint64> GetTextKey(uint32 stringID) const
     {
         if (auto const info = GetTextKeyInfo(stringID); info && info->Key)
@@ -52,11 +55,26 @@ public:
         return { };
     }
 
+    void AddContentFileKey(uint32 fileID, uint64 key)
+    {
+        std::unique_lock _(m_lock);
+        m_contentFileKeys[fileID] = key;
+    }
+    [[nodiscard]] std::optional<uint64> GetContentFileKey(uint32 fileID) const
+    {
+        std::shared_lock _(m_lock);
+        if (auto const itr = m_contentFileKeys.find(fileID); itr != m_contentFileKeys.end())
+            return itr->second;
+        return { };
+    }
+
 private:
     mutable std::shared_mutex m_lock;
     std::unordered_map<uint32, TextKeyInfo> m_textKeys;
     std::vector<TextKeyInfo*> m_textKeysByOrder;
+    std::atomic<uint32> m_textKeysVersion = 0;
     std::map<std::pair<AssetType, uint32>, uint64> m_assetKeys;
+    std::unordered_map<uint32, uint64> m_contentFileKeys; // Not part of the external database, entered by the user and kept in the config
 };
 
 }
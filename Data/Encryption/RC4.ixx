@@ -24,11 +24,20 @@ struct RC4
     }
     void Crypt(std::span<byte> data)
     {
-        for (byte& b : data)
+        // The keystream can only be generated serially, so it's generated a block at a time to leave a plain XOR loop that the compiler vectorizes
+        std::array<byte, 4096> stream;
+        while (!data.empty())
         {
-            y += m[++x];
-            std::swap(m[x], m[y]);
-            b ^= m[(byte)(m[x] + m[y])];
+            auto const block = data.first(std::min(data.size(), stream.size()));
+            for (byte& s : std::span(stream).first(block.size()))
+            {
+                y += m[++x];
+                std::swap(m[x], m[y]);
+                s = m[(byte)(m[x] + m[y])];
+            }
+            for (size_t i = 0; i < block.size(); ++i)
+                block[i] ^= stream[i];
+            data = data.subspan(block.size());
         }
     }
 
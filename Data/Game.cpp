@@ -1,4 +1,8 @@
-﻿module GW2Viewer.Data.Game;
+﻿module;
+#include <mio/mmap.hpp>
+#include <emmintrin.h>
+
+module GW2Viewer.Data.Game;
 import GW2Viewer.Common.Time;
 import GW2Viewer.Data.Pack;
 import GW2Viewer.Utils.ScanPE;
@@ -6,57 +10,198 @@ import GW2Viewer.Utils.ScanPE;
 namespace GW2Viewer::Data
 {
 
-void Game::Load(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress)
+#pragma pack(push, 1)
+struct ReferencesCacheHeader
+{
+    static constexpr byte CurrentVersion = 1;
+
+    uint32 FourCC = std::byteswap('GW2V');
+    uint32 FourCC2 = std::byteswap('GREF');
+    byte Version = CurrentVersion;
+    byte Reserved0 = 0;
+    byte Reserved1 = 0;
+    byte Reserved2 = 0;
+    uint32 ExeCRC = 0;
+    uint64 ExeSize = 0;
+    uint32 Build = 0;
+    uint32 NumChains = 0;
+    uint32 NumFileIDs = 0;
+    byte Reserved[0x40 - 0x24] { };
+};
+static_assert(sizeof(ReferencesCacheHeader) == 0x40);
+#pragma pack(pop)
+
+// File reference arrays found in the executable, unfiltered by archive contents. Each chain ends where the original array ended.
+struct ReferenceChains
 {
-    progress.Start(std::format("Parsing build info from {}", path.filename().string()));
-    Utils::ScanPE::Scanner scanner { path };
+    uint32 Build = 0;
+    std::vector<uint32> Lengths;
+    std::vector<uint32> FileIDs;
+};
+
+std::optional<ReferenceChains> LoadReferencesCache(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key)
+{
+    if (!exists(path))
+        return { };
+
+    std::error_code error;
+    mio::mmap_source file;
+    file.map(path.native(), error);
+    if (error || file.size() < sizeof(ReferencesCacheHeader))
+        return { };
+
+    auto const& header = *(ReferencesCacheHeader const*)file.data();
+    if (header.FourCC != ReferencesCacheHeader().FourCC || header.FourCC2 != ReferencesCacheHeader().FourCC2 || header.Version != ReferencesCacheHeader::CurrentVersion)
+        return { };
+    if (header.ExeSize != key.Size || header.ExeCRC != key.CRC)
+        return { };
+    if (file.size() != sizeof(ReferencesCacheHeader) + (header.NumChains + header.NumFileIDs) * sizeof(uint32))
+        return { };
 
-    if (auto const branch = std::ranges::search(scanner.rdata, std::span((byte const*)L"Gw2\0", 8)); !branch.empty())
+    auto const data = (uint32 const*)(file.data() + sizeof(ReferencesCacheHeader));
+    return ReferenceChains
     {
-        static auto skipPadding = [](byte const*& p) { while (*++p == 0xCC) { } };
-        uint32 offset;
-        auto const pOffset = (byte const*)&offset;
-        auto const pOffsetEnd = pOffset + sizeof(offset);
-        for (byte const* p = scanner.text.begin(); p != scanner.text.end() - sizeof(offset); ++p)
-            if (uint64 const longOffset = branch.data() - p - sizeof(offset); longOffset <= std::numeric_limits<decltype(offset)>::max())
-                if (offset = (decltype(offset))longOffset; std::ranges::equal(p, p + sizeof(offset), pOffset, pOffsetEnd) && (p[-3] == 0x48 || p[-3] == 0x4C) && p[-2] == 0x8D)
-                    if (*(p += 4) == 0xC3)
-                        if (skipPadding(p), (p[0] == 0x48 || p[0] == 0x4C) && p[1] == 0x8D && *(p += 7) == 0xC3)
-                            if (skipPadding(p), p[0] == 0xB8)
-                                if (uint32 const build = *(uint32 const*)&p[1]; build < 300000 && ((Build = build)))
-                                    break;
-    }
+        .Build = header.Build,
+        .Lengths = std::vector<uint32>(data, data + header.NumChains),
+        .FileIDs = std::vector<uint32>(data + header.NumChains, data + header.NumChains + header.NumFileIDs),
+    };
+}
 
-    progress.Start("Searching for embedded filenames", scanner.text.size());
-    while (!G::Game.Archive.IsLoaded())
-        std::this_thread::sleep_for(50ms);
+void SaveReferencesCache(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key, ReferenceChains const& chains)
+{
+    ReferencesCacheHeader const header
+    {
+        .ExeCRC = key.CRC,
+        .ExeSize = key.Size,
+        .Build = chains.Build,
+        .NumChains = (uint32)chains.Lengths.size(),
+        .NumFileIDs = (uint32)chains.FileIDs.size(),
+    };
+    std::ofstream file(path, std::ios::binary);
+    file.write((char const*)&header, sizeof(header));
+    file.write((char const*)chains.Lengths.data(), chains.Lengths.size() * sizeof(uint32));
+    file.write((char const*)chains.FileIDs.data(), chains.FileIDs.size() * sizeof(uint32));
+}
 
-    for (byte const* p = scanner.text.begin(); p != scanner.text.end() - 7; ++p)
+// Calls callback for every position in [begin, end) that starts with a REX.W/REX.WR prefixed lea opcode (48/4C 8D), reads up to one byte past end
+template<typename Callback>
+void ForEachLea(byte const* begin, byte const* end, byte const* limit, Callback&& callback)
+{
+    __m128i const rexMask = _mm_set1_epi8((char)0xFB);
+    __m128i const rex = _mm_set1_epi8(0x48);
+    __m128i const opcode = _mm_set1_epi8((char)0x8D);
+    auto p = begin;
+    for (; p < end && p + 17 <= limit; p += 16)
     {
+        __m128i const first = _mm_loadu_si128((__m128i const*)p);
+        __m128i const second = _mm_loadu_si128((__m128i const*)(p + 1));
+        for (uint32 mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(first, rexMask), rex), _mm_cmpeq_epi8(second, opcode))); mask; mask &= mask - 1)
+            if (auto const match = p + std::countr_zero(mask); match < end)
+                callback(match);
+    }
+    for (; p < end && p + 1 < limit; ++p)
         if ((p[0] == 0x48 || p[0] == 0x4C) && p[1] == 0x8D)
+            callback(p);
+}
+
+void Game::HashExecutable(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress)
+{
+    progress.Start(std::format("Hashing {}", path.filename().string()));
+    ExecutableKey = Utils::ScanPE::GetFileKey(path);
+}
+
+void Game::Load(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress)
+{
+    auto const& key = ExecutableKey;
+    static std::filesystem::path const cachePath = "GameReferences.bin";
+
+    auto chains = key ? LoadReferencesCache(cachePath, key) : std::nullopt;
+    if (!chains)
+    {
+        progress.Start(std::format("Parsing build info from {}", path.filename().string()));
+        Utils::ScanPE::Scanner scanner { path };
+
+        auto const branch = std::ranges::search(scanner.rdata, std::span((byte const*)L"Gw2\0", 8));
+        auto matchBuild = [&scanner, &branch](byte const* p) -> std::optional<uint32>
+        {
+            static auto skipPadding = [](byte const*& p) { while (*++p == 0xCC) { } };
+            if (scanner.GetTargetFromOffset32(p + 3) != branch.data())
+                return { };
+            p += 3;
+            if (*(p += 4) == 0xC3)
+                if (skipPadding(p), (p[0] == 0x48 || p[0] == 0x4C) && p[1] == 0x8D && *(p += 7) == 0xC3)
+                    if (skipPadding(p), p[0] == 0xB8)
+                        if (uint32 const build = *(uint32 const*)&p[1]; build && build < 300000)
+                            return build;
+            return { };
+        };
+        auto collectChain = [&scanner](byte const* target, ReferenceChains& result)
         {
-            for (auto target = p + 7 + *(uint32 const*)&p[3]; (scanner.rdata.Contains(target) || scanner.data.Contains(target)) && !target[6] && !target[7]; target += 8)
+            uint32 length = 0;
+            for (; (scanner.rdata.Contains(target) || scanner.data.Contains(target)) && !target[6] && !target[7]; target += 8, ++length)
             {
-                if (uint32 const fileID = ((Pack::FileReference const*)target)->GetFileID(); fileID && fileID <= G::Game.Archive.GetMaxFileID())
-                    ReferencedFiles.emplace(fileID);
+                if (uint32 const fileID = ((Pack::FileReference const*)target)->GetFileID())
+                    result.FileIDs.emplace_back(fileID);
                 else
                     break;
             }
-            if (auto indirection = (byte const* const*)(p + 7 + *(uint32 const*)&p[3]); scanner.rdata.Contains(indirection) || scanner.data.Contains(indirection))
+            if (length)
+                result.Lengths.emplace_back(length);
+        };
+
+        // Each range owns the lea instructions starting inside it, but may read past its end, so instructions straddling a boundary are found exactly once
+        static constexpr size_t RangeSize = 1024 * 1024;
+        std::vector<ReferenceChains> ranges((scanner.text.size() + RangeSize - 1) / RangeSize);
+        std::atomic<size_t> scanned = 0;
+        progress.Start("Searching for embedded filenames", scanner.text.size());
+        std::for_each(std::execution::par, ranges.begin(), ranges.end(), [&](ReferenceChains& result)
+        {
+            auto const begin = scanner.text.begin() + std::distance(ranges.data(), &result) * RangeSize;
+            auto const end = std::min(begin + RangeSize, scanner.text.end() - 7);
+            if (begin < end)
             {
-                for (auto target = *indirection; (scanner.rdata.Contains(target) || scanner.data.Contains(target)) && !target[6] && !target[7]; target += 8)
+                ForEachLea(begin, end, scanner.text.end(), [&](byte const* p)
                 {
-                    if (uint32 const fileID = ((Pack::FileReference const*)target)->GetFileID(); fileID && fileID <= G::Game.Archive.GetMaxFileID())
-                        ReferencedFiles.emplace(fileID);
-                    else
-                        break;
-                }
+                    if (!result.Build && !branch.empty())
+                        if (auto const build = matchBuild(p))
+                            result.Build = *build;
+
+                    auto const target = scanner.GetTargetFromOffset32(p + 3);
+                    collectChain(target, result);
+                    if (scanner.rdata.Contains(target) || scanner.data.Contains(target))
+                        collectChain(scanner.ResolveVA(*(uint64 const*)target), result);
+                });
             }
+            progress = scanned += std::distance(begin, std::min(begin + RangeSize, scanner.text.end()));
+        });
+
+        chains.emplace();
+        for (auto& range : ranges)
+        {
+            if (!chains->Build)
+                chains->Build = range.Build;
+            chains->Lengths.append_range(range.Lengths);
+            chains->FileIDs.append_range(range.FileIDs);
         }
+        if (key)
+            SaveReferencesCache(cachePath, key, *chains);
+    }
+
+    Build = chains->Build;
 
-        if (static constexpr uint32 interval = 1000; !(std::distance(scanner.text.begin(), p) % interval))
-            progress += interval;
+    progress.Start("Waiting for archive");
+    G::Game.Archive.WaitUntilLoaded();
+
+    ReferencedFiles.clear();
+    auto fileIDs = chains->FileIDs.begin();
+    for (auto const length : chains->Lengths)
+    {
+        auto const chain = std::ranges::subrange(fileIDs, fileIDs + length);
+        ReferencedFiles.append_range(chain | std::views::take_while([max = G::Game.Archive.GetMaxFileID()](uint32 fileID) { return fileID <= max; }));
+        fileIDs += length;
     }
+    std::ranges::sort(ReferencedFiles);
+    ReferencedFiles.erase(std::ranges::unique(ReferencedFiles).begin(), ReferencedFiles.end());
 }
 
 }
@@ -9,6 +9,7 @@ import GW2Viewer.Data.Text.Manager;
 import GW2Viewer.Data.Texture.Manager;
 import GW2Viewer.Data.Voice.Manager;
 import GW2Viewer.Utils.Async.ProgressBarContext;
+import GW2Viewer.Utils.ScanPE;
 import std;
 
 export namespace GW2Viewer::Data
@@ -17,7 +18,8 @@ export namespace GW2Viewer::Data
 struct Game
 {
     uint32 Build = 0;
-    std::set<uint32> ReferencedFiles;
+    std::vector<uint32> ReferencedFiles;
+    Utils::ScanPE::FileKey ExecutableKey; // Keys the caches of everything parsed from the executable, so it's only hashed once
 
     Archive::Manager Archive;
     Content::Manager Content;
@@ -28,6 +30,9 @@ struct Game
     Texture::Manager Texture;
     Voice::Manager Voice;
 
+    [[nodiscard]] bool IsReferencedFile(uint32 fileID) const { return std::ranges::binary_search(ReferencedFiles, fileID); }
+
+    void HashExecutable(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress);
     void Load(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress);
 };
 
@@ -1,5 +1,6 @@
 export module GW2Viewer.Data.Manifest.Asset;
 import GW2Viewer.Common;
+import GW2Viewer.Utils.Intern;
 import <boost/container/flat_set.hpp>;
 import <boost/container/small_vector.hpp>;
 
@@ -8,13 +9,15 @@ export namespace GW2Viewer::Data::Manifest
 
 struct Asset
 {
-    boost::container::small_flat_set<wchar_t const*, 20> ManifestNames;
+    boost::container::small_flat_set<uint32, 20> ManifestNames; // Interned, there are only a few hundred manifests for all assets
     uint32 BaseID = 0; // ID of the file when it was first added to the archive
     uint32 FileID = 0; // ID of the latest version of the file, only 1 latest version is retained in the archive
     uint32 Size = 0;
     uint32 Flags = 0;
     uint32 ParentBaseID = 0; // ID of the lower quality version of the file
     uint32 StreamBaseID = 0; // ID of the higher quality version of the file
+
+    [[nodiscard]] auto GetManifestNames() const { return ManifestNames | std::views::transform([](uint32 id) { return Utils::Intern::GetTable<wchar_t>().Get(id); }); }
 };
 
 }
@@ -5,6 +5,7 @@ module GW2Viewer.Data.Manifest.Manager;
 import GW2Viewer.Common.FourCC;
 import GW2Viewer.Data.Game;
 import GW2Viewer.Utils.Encoding;
+import GW2Viewer.Utils.Intern;
 
 namespace GW2Viewer::Data::Manifest
 {
@@ -19,8 +20,9 @@ void Manager::LoadRootManifest(uint32 fileID, Utils::Async::ProgressBarContext&
             progress.Start(root["manifests[]"].GetArraySize());
             for (auto const& manifest : root["manifests"])
             {
-                auto const manifestName = ((std::wstring_view)manifest["name"]).data();
-                progress.SetDescription(std::format("Loading manifests:\n{}", Utils::Encoding::ToUTF8(manifestName)));
+                auto const name = (std::wstring_view)manifest["name"];
+                auto const manifestName = Utils::Intern::Intern(name);
+                progress.SetDescription(std::format("Loading manifests:\n{}", Utils::Encoding::ToUTF8(name)));
                 LinkAssetVersions(manifest["baseId"], manifest["fileId"], manifest["size"], manifest["flags"], manifestName);
                 LoadAssetManifest(manifest["baseId"], manifestName);
                 ++progress;
@@ -28,12 +30,10 @@ void Manager::LoadRootManifest(uint32 fileID, Utils::Async::ProgressBarContext&
             for (auto const& extraFile : root["extraFiles"])
                 LoadRootManifest(extraFile["baseId"], progress);
         }
-
-        m_rootManifestPackFiles.emplace_back(std::move(rootPackFile));
     }
 }
 
-void Manager::LoadAssetManifest(uint32 fileID, wchar_t const* manifestName)
+void Manager::LoadAssetManifest(uint32 fileID, uint32 manifestName)
 {
     if (auto const manifestPackFile = G::Game.Archive.GetPackFile(fileID))
     {
@@ -59,7 +59,7 @@ void Manager::LoadAssetManifest(uint32 fileID, wchar_t const* manifestName)
     }
 }
 
-void Manager::LinkAssetVersions(uint32 baseId, uint32 fileId, uint32 size, uint32 flags, wchar_t const* manifestName)
+void Manager::LinkAssetVersions(uint32 baseId, uint32 fileId, uint32 size, uint32 flags, uint32 manifestName)
 {
     if (auto const file = G::Game.Archive.GetFileEntry(baseId))
     {
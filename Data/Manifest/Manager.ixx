@@ -16,12 +16,10 @@ struct Manager
     }
 
 private:
-    std::vector<std::unique_ptr<Pack::PackFile>> m_rootManifestPackFiles;
-
     void LoadRootManifest(uint32 fileID, Utils::Async::ProgressBarContext& progress);
-    void LoadAssetManifest(uint32 fileID, wchar_t const* manifestName);
+    void LoadAssetManifest(uint32 fileID, uint32 manifestName);
 
-    void LinkAssetVersions(uint32 baseId, uint32 fileId, uint32 size, uint32 flags, wchar_t const* manifestName);
+    void LinkAssetVersions(uint32 baseId, uint32 fileId, uint32 size, uint32 flags, uint32 manifestName);
     void LinkAssetStreams(uint32 parentBaseId, uint32 streamBaseId);
 };
 
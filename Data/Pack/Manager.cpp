@@ -1,104 +1,360 @@
-﻿module GW2Viewer.Data.Pack.Manager;
+﻿module;
+#include <mio/mmap.hpp>
+
+module GW2Viewer.Data.Pack.Manager;
 import GW2Viewer.Utils.ScanPE;
 import <cctype>;
 
 namespace GW2Viewer::Data::Pack
 {
 
-void Manager::Load(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress)
+#pragma pack(push, 1)
+struct CacheHeader
+{
+    static constexpr byte CurrentVersion = 1;
+
+    uint32 FourCC = std::byteswap('GW2V');
+    uint32 FourCC2 = std::byteswap('PFLO');
+    byte Version = CurrentVersion;
+    byte Reserved0 = 0;
+    byte Reserved1 = 0;
+    byte Reserved2 = 0;
+    uint32 ExeCRC = 0;
+    uint64 ExeSize = 0;
+    uint32 NumTypes = 0;
+    uint32 NumFields = 0;
+    uint32 NumVariantElementTypes = 0;
+    uint32 NumChunks = 0;
+    uint32 NumChunkVersions = 0;
+    uint32 StringsSize = 0;
+    byte Reserved[0x40 - 0x30] { };
+};
+static_assert(sizeof(CacheHeader) == 0x40);
+struct CacheString
+{
+    uint32 Offset;
+    uint32 Length;
+};
+struct CacheType
+{
+    CacheString Name;
+    uint32 DeclaredSize;
+    uint32 FirstField;
+    uint32 NumFields;
+};
+static_assert(sizeof(CacheType) == 0x14);
+struct CacheField
+{
+    static constexpr uint32 NoType = -1;
+
+    CacheString Name;
+    Layout::UnderlyingTypes UnderlyingType;
+    Layout::RealTypes RealType;
+    uint32 ArraySize;
+    uint32 ElementType;
+    uint32 FirstVariantElementType;
+    uint32 NumVariantElementTypes;
+};
+static_assert(sizeof(CacheField) == 0x1C);
+struct CacheChunk
+{
+    CacheString Name;
+    uint32 FirstVersion;
+    uint32 NumVersions;
+};
+static_assert(sizeof(CacheChunk) == 0x10);
+struct CacheChunkVersion
+{
+    uint32 Version;
+    uint32 Type;
+};
+static_assert(sizeof(CacheChunkVersion) == 0x8);
+#pragma pack(pop)
+
+void Manager::Load(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key, Utils::Async::ProgressBarContext& progress)
+{
+    m_chunks.clear();
+    m_types.clear();
+
+    static std::filesystem::path const cachePath = "PackFileLayouts.bin";
+    if (!key || !LoadCache(cachePath, key))
+    {
+        Scan(path, progress);
+        if (key)
+            SaveCache(cachePath, key);
+    }
+
+    m_loaded = true;
+}
+
+void Manager::Scan(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress)
 {
     progress.Start(std::format("Parsing PackFile layouts from {}", path.filename().string()));
     using namespace Layout;
     Utils::ScanPE::Scanner scanner { path };
 
+    // Pointers inside the image are virtual addresses and have to be resolved through the scanner
     struct PackFileField
     {
         UnderlyingTypes UnderlyingType;
         RealTypes RealType;
         uint32 Unk;
-        char const* Name;
-        union
-        {
-            PackFileField* ElementFields;
-            PackFileField** VariantElementFields;
-            void(*PostProcessStruct)();
-        };
+        uint64 Name;
+        uint64 Elements; // PackFileField* ElementFields, PackFileField** VariantElementFields or void(*PostProcessStruct)()
         uint16 Size;
     };
     struct PackFileVersion
     {
-        PackFileField* Fields;
-        void* PostProcessFunction;
-        void* Unk;
+        uint64 Fields;
+        uint64 PostProcessFunction;
+        uint64 Unk;
+    };
+    auto isFieldsAddress = [&scanner](uint64 va) { return scanner.rdata.ContainsVA(va) || scanner.data.ContainsVA(va); };
+    auto getString = [&scanner](uint64 va) -> std::string { if (auto const string = scanner.rdata.FromVA<char>(va)) return string; return { }; };
+    auto collectVariants = [&scanner](uint64 elementsAddress, uint16 count, auto& collect)
+    {
+        std::vector<Type const*> result;
+        if (auto const elements = scanner.ResolveVA<uint64>(elementsAddress))
+            result.assign_range(std::span { elements, count } | std::views::transform([&collect](uint64 fields) { return collect(fields, collect); }));
+        return result;
     };
-    auto collect = [&](PackFileField* fields, auto& collect) -> Type const*
+    std::unordered_map<uint64, Type const*> types;
+    auto collect = [&](uint64 fieldsAddress, auto& collect) -> Type const*
     {
+        if (!fieldsAddress)
+            return nullptr;
+        auto const fields = scanner.ResolveVA<PackFileField>(fieldsAddress);
         if (!fields)
             return nullptr;
-        PackFileField* field = fields;
-        while (true)
+        for (auto field = fields; scanner.rdata.Contains(field + 1) || scanner.data.Contains(field + 1); ++field)
         {
-            if (!scanner.rdata.Valid(field->Name))
+            if (!scanner.rdata.ValidVA(field->Name))
                 return nullptr;
-            if (field->UnderlyingType != UnderlyingTypes::StructDefinition && !scanner.rdata.Valid(field->ElementFields) && !scanner.data.Valid(field->ElementFields))
+            if (field->UnderlyingType != UnderlyingTypes::StructDefinition && field->Elements && !isFieldsAddress(field->Elements))
                 return nullptr;
             if (field->UnderlyingType == UnderlyingTypes::StructDefinition)
-                return &m_types.try_emplace((byte const*)fields,
-                    field->Name,
+            {
+                if (auto const itr = types.find(fieldsAddress); itr != types.end())
+                    return itr->second;
+
+                Type type
+                {
+                    getString(field->Name),
                     field->Size,
                     std::vector { std::from_range,
                     std::span { fields, field }
                     | std::views::transform([&](PackFileField const& field) -> Field {
                         return {
-                            field.Name,
+                            getString(field.Name),
                             field.UnderlyingType,
                             field.RealType,
                             field.Size,
-                            field.UnderlyingType != UnderlyingTypes::Variant ? collect(field.ElementFields, collect) : nullptr,
-                            field.UnderlyingType == UnderlyingTypes::Variant ? std::vector { std::from_range, std::span { field.VariantElementFields, field.Size } | std::views::transform([&collect](auto* fields) { return collect(fields, collect); }) } : std::vector<Type const*> { },
+                            field.UnderlyingType != UnderlyingTypes::Variant ? collect(field.Elements, collect) : nullptr,
+                            field.UnderlyingType == UnderlyingTypes::Variant ? collectVariants(field.Elements, field.Size, collect) : std::vector<Type const*> { },
                         };
                     })
-                }).first->second;
-            ++field;
+                    },
+                };
+                return types.emplace(fieldsAddress, &m_types.emplace_back(std::move(type))).first->second;
+            }
         }
+        return nullptr;
     };
 
+    // Cheap candidate detection runs in parallel over fixed address ranges. Each range owns the descriptors that start inside it,
+    // but is allowed to read past its end into the next range, so descriptors straddling a boundary are still found exactly once.
+    struct Candidate
+    {
+        byte const* Name;
+        uint32 NumVersions;
+        PackFileVersion const* Versions;
+    };
+    static constexpr size_t RangeSize = 1024 * 1024;
+    static_assert(!(RangeSize % sizeof(void*)));
+    std::vector<std::vector<Candidate>> rangeCandidates((scanner.rdata.size() + RangeSize - 1) / RangeSize);
+    std::atomic<size_t> scanned = 0;
     progress.Start(scanner.rdata.size());
-    for (auto p = scanner.rdata.begin(); p < scanner.rdata.end(); p += sizeof(void*))
+    std::for_each(std::execution::par, rangeCandidates.begin(), rangeCandidates.end(), [&](std::vector<Candidate>& candidates)
     {
-        if (isalnum(p[0]) && isalnum(p[1]) && isalnum(p[2]) && (!p[3] || isalnum(p[3])))
+        auto const begin = scanner.rdata.begin() + std::distance(rangeCandidates.data(), &candidates) * RangeSize;
+        auto const end = std::min(begin + RangeSize, scanner.rdata.end());
+        for (auto p = begin; p < end; p += sizeof(void*))
         {
+            if (!(isalnum(p[0]) && isalnum(p[1]) && isalnum(p[2]) && (!p[3] || isalnum(p[3]))))
+                continue;
+
             uint32 const numVersions = *(uint32 const*)&p[4];
             if (!numVersions || numVersions > 100)
                 continue;
 
-            if (auto const versions = *(PackFileVersion**)&p[8]; versions && scanner.rdata.Valid(versions))
-            {
-                for (uint32 versionNum = 0; versionNum < numVersions; ++versionNum)
-                {
-                    auto& version = versions[versionNum];
-                    if (!version.Fields)
-                        continue;
-                    if (!scanner.rdata.Valid(version.Fields))
-                        goto fail;
-                    if (!scanner.text.Valid(version.PostProcessFunction))
-                        goto fail;
-
-                    if (auto type = collect(version.Fields, collect))
-                        m_chunks[std::string((char const*)p, p[3] ? 4 : 3)].try_emplace(versionNum, type);
-                    else
-                        goto fail;
-                }
-            }
+            if (auto const versions = scanner.rdata.FromVA<PackFileVersion>(*(uint64 const*)&p[8]))
+                candidates.emplace_back(p, numVersions, versions);
+        }
+        progress = scanned += std::distance(begin, end);
+    });
+
+    // Type collection shares the deduplication map, so it stays serial and visits candidates in address order to keep the result deterministic
+    for (auto const& [name, numVersions, versions] : rangeCandidates | std::views::join)
+    {
+        for (uint32 versionNum = 0; versionNum < numVersions; ++versionNum)
+        {
+            auto& version = versions[versionNum];
+            if (!version.Fields)
+                continue;
+            if (!scanner.rdata.ValidVA(version.Fields))
+                break;
+            if (!scanner.text.ValidVA(version.PostProcessFunction))
+                break;
 
-        fail:;
+            if (auto type = collect(version.Fields, collect))
+                m_chunks[std::string((char const*)name, name[3] ? 4 : 3)].try_emplace(versionNum, type);
+            else
+                break;
         }
+    }
+}
+
+bool Manager::LoadCache(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key)
+{
+    if (!exists(path))
+        return false;
+
+    std::error_code error;
+    mio::mmap_source file;
+    file.map(path.native(), error);
+    if (error || file.size() < sizeof(CacheHeader))
+        return false;
+
+    auto p = (byte const*)file.data();
+    auto const& header = *(CacheHeader const*)p;
+    if (header.FourCC != CacheHeader().FourCC || header.FourCC2 != CacheHeader().FourCC2 || header.Version != CacheHeader::CurrentVersion)
+        return false;
+    if (header.ExeSize != key.Size || header.ExeCRC != key.CRC)
+        return false;
+    if (file.size() != sizeof(CacheHeader)
+        + header.NumTypes * sizeof(CacheType)
+        + header.NumFields * sizeof(CacheField)
+        + header.NumVariantElementTypes * sizeof(uint32)
+        + header.NumChunks * sizeof(CacheChunk)
+        + header.NumChunkVersions * sizeof(CacheChunkVersion)
+        + header.StringsSize)
+        return false;
 
-        if (auto const offset = std::distance(scanner.rdata.begin(), p); !(offset % (100 * sizeof(void*))))
-            progress = offset;
+    p += sizeof(CacheHeader);
+    auto read = [&p]<typename T>(std::span<T const>& result, uint32 count)
+    {
+        result = { (T const*)p, count };
+        p += result.size_bytes();
+    };
+    std::span<CacheType const> types;
+    std::span<CacheField const> fields;
+    std::span<uint32 const> variantElementTypes;
+    std::span<CacheChunk const> chunks;
+    std::span<CacheChunkVersion const> chunkVersions;
+    read(types, header.NumTypes);
+    read(fields, header.NumFields);
+    read(variantElementTypes, header.NumVariantElementTypes);
+    read(chunks, header.NumChunks);
+    read(chunkVersions, header.NumChunkVersions);
+    std::string_view const strings { (char const*)p, header.StringsSize };
+
+    // A corrupt cache is rescanned, so everything it references has to be in range before anything is built from it
+    auto isRange = [](uint32 first, uint32 count, size_t size) { return first <= size && count <= size - first; };
+    auto isString = [&](CacheString const& string) { return isRange(string.Offset, string.Length, strings.size()); };
+    auto isType = [&header](uint32 index) { return index == CacheField::NoType || index < header.NumTypes; };
+    if (!std::ranges::all_of(types, [&](CacheType const& type) { return isString(type.Name) && isRange(type.FirstField, type.NumFields, fields.size()); })
+        || !std::ranges::all_of(fields, [&](CacheField const& field) { return isString(field.Name) && isType(field.ElementType) && isRange(field.FirstVariantElementType, field.NumVariantElementTypes, variantElementTypes.size()); })
+        || !std::ranges::all_of(variantElementTypes, isType)
+        || !std::ranges::all_of(chunks, [&](CacheChunk const& chunk) { return isString(chunk.Name) && isRange(chunk.FirstVersion, chunk.NumVersions, chunkVersions.size()); })
+        || !std::ranges::all_of(chunkVersions, [&](CacheChunkVersion const& version) { return isType(version.Type); }))
+        return false;
+
+    auto getString = [strings](CacheString const& string) { return std::string(strings.substr(string.Offset, string.Length)); };
+    auto getType = [this](uint32 index) -> Layout::Type const* { return index != CacheField::NoType ? &m_types[index] : nullptr; };
+
+    m_types.resize(header.NumTypes);
+    for (auto&& [cached, type] : std::views::zip(types, m_types))
+    {
+        type.Name = getString(cached.Name);
+        type.DeclaredSize = cached.DeclaredSize;
+        type.Fields = std::vector<Layout::Field> { std::from_range, fields.subspan(cached.FirstField, cached.NumFields) | std::views::transform([&](CacheField const& field) -> Layout::Field
+        {
+            return {
+                getString(field.Name),
+                field.UnderlyingType,
+                field.RealType,
+                field.ArraySize,
+                getType(field.ElementType),
+                std::vector { std::from_range, variantElementTypes.subspan(field.FirstVariantElementType, field.NumVariantElementTypes) | std::views::transform(getType) },
+            };
+        }) };
+    }
+    for (auto const& chunk : chunks)
+    {
+        auto& versions = m_chunks[getString(chunk.Name)];
+        for (auto const& [version, type] : chunkVersions.subspan(chunk.FirstVersion, chunk.NumVersions))
+            versions.try_emplace(version, getType(type));
     }
+    return true;
+}
 
-    m_loaded = true;
+void Manager::SaveCache(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key) const
+{
+    std::unordered_map<Layout::Type const*, uint32> typeIndices;
+    for (auto const& type : m_types)
+        typeIndices.emplace(&type, (uint32)typeIndices.size());
+    auto getIndex = [&typeIndices](Layout::Type const* type) { return type ? typeIndices.at(type) : CacheField::NoType; };
+
+    std::string strings;
+    auto addString = [&strings](std::string_view string) -> CacheString
+    {
+        CacheString const result { (uint32)strings.size(), (uint32)string.size() };
+        strings.append(string);
+        return result;
+    };
+
+    std::vector<CacheType> types;
+    std::vector<CacheField> fields;
+    std::vector<uint32> variantElementTypes;
+    std::vector<CacheChunk> chunks;
+    std::vector<CacheChunkVersion> chunkVersions;
+    for (auto const& type : m_types)
+    {
+        types.emplace_back(addString(type.Name), type.DeclaredSize, (uint32)fields.size(), (uint32)type.Fields.size());
+        for (auto const& field : type.Fields)
+        {
+            fields.emplace_back(addString(field.Name), field.UnderlyingType, field.RealType, field.ArraySize, getIndex(field.ElementType), (uint32)variantElementTypes.size(), (uint32)field.VariantElementTypes.size());
+            variantElementTypes.append_range(field.VariantElementTypes | std::views::transform(getIndex));
+        }
+    }
+    for (auto const& [name, versions] : m_chunks)
+    {
+        chunks.emplace_back(addString(name), (uint32)chunkVersions.size(), (uint32)versions.size());
+        for (auto const& [version, type] : versions)
+            chunkVersions.emplace_back(version, getIndex(type));
+    }
+
+    CacheHeader const header
+    {
+        .ExeCRC = key.CRC,
+        .ExeSize = key.Size,
+        .NumTypes = (uint32)types.size(),
+        .NumFields = (uint32)fields.size(),
+        .NumVariantElementTypes = (uint32)variantElementTypes.size(),
+        .NumChunks = (uint32)chunks.size(),
+        .NumChunkVersions = (uint32)chunkVersions.size(),
+        .StringsSize = (uint32)strings.size(),
+    };
+
+    std::ofstream file(path, std::ios::binary);
+    auto write = [&file](auto const& data) { file.write((char const*)std::ranges::data(data), std::ranges::size(data) * sizeof(*std::ranges::data(data))); };
+    write(std::span { &header, 1 });
+    write(types);
+    write(fields);
+    write(variantElementTypes);
+    write(chunks);
+    write(chunkVersions);
+    write(strings);
 }
 
 }
@@ -3,6 +3,7 @@ import GW2Viewer.Common;
 import GW2Viewer.Data.Pack.PackFile;
 import GW2Viewer.Utils.Async.ProgressBarContext;
 import GW2Viewer.Utils.Container;
+import GW2Viewer.Utils.ScanPE;
 import std;
 
 export namespace GW2Viewer::Data::Pack
@@ -13,13 +14,17 @@ class Manager
 public:
     auto GetChunk(std::string_view name) const { return Utils::Container::Find(m_chunks, name); }
 
-    void Load(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress);
+    void Load(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key, Utils::Async::ProgressBarContext& progress);
     bool IsLoaded() const { return m_loaded; }
 
 private:
     bool m_loaded = false;
-    std::unordered_map<byte const*, Layout::Type> m_types;
+    std::deque<Layout::Type> m_types;
     std::map<std::string, std::map<uint32, Layout::Type const*>, std::less<>> m_chunks;
+
+    void Scan(std::filesystem::path const& path, Utils::Async::ProgressBarContext& progress);
+    bool LoadCache(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key);
+    void SaveCache(std::filesystem::path const& path, Utils::ScanPE::FileKey const& key) const;
 };
 
 }
@@ -0,0 +1,230 @@
+export module GW2Viewer.Data.Pack.PackFile:Allocator;
+import GW2Viewer.Common;
+import std;
+
+export namespace GW2Viewer::Data::Pack
+{
+
+class PackFileAllocator
+{
+public:
+    static constexpr size_t SlabSize = 1 << 20;
+    static constexpr size_t MaxSlabBlockSize = 64 << 10;
+    static constexpr size_t MaxCachedBlockSize = 256 << 20;
+    static constexpr size_t CacheBudget = 256 << 20;
+
+    struct SizeClassStats
+    {
+        size_t BlockSize = 0;
+        size_t Requests = 0;
+        size_t Reused = 0;
+        size_t LiveBlocks = 0;
+        size_t LiveBytes = 0;
+        size_t CachedBlocks = 0;
+        size_t Slabs = 0;
+    };
+    struct Stats
+    {
+        std::vector<SizeClassStats> Classes;
+        SizeClassStats Direct;
+        size_t ReservedBytes = 0;
+        size_t CachedBytes = 0;
+    };
+
+    [[nodiscard]] void* Allocate(size_t size)
+    {
+        size_t const total = sizeof(BlockHeader) + size;
+        auto const index = GetSizeClassIndex(total);
+        if (index == DirectSizeClass)
+        {
+            auto const block = (byte*)operator new(total);
+            {
+                std::scoped_lock _(m_directMutex);
+                ++m_direct.Requests;
+                ++m_direct.LiveBlocks;
+                m_direct.LiveBytes += size;
+                m_reservedBytes += total;
+            }
+            return Initialize(block, DirectSizeClass, size);
+        }
+
+        auto& sizeClass = m_classes[index];
+        byte* block;
+        {
+            std::scoped_lock _(sizeClass.Mutex);
+            ++sizeClass.Requests;
+            ++sizeClass.LiveBlocks;
+            sizeClass.LiveBytes += size;
+            if (!sizeClass.Free.empty())
+            {
+                block = sizeClass.Free.back();
+                sizeClass.Free.pop_back();
+                ++sizeClass.Reused;
+                if (!IsSlabClass(index))
+                    m_cachedBytes -= SizeClasses[index];
+            }
+            else if (IsSlabClass(index))
+            {
+                auto const slab = (byte*)operator new(SlabSize, std::align_val_t(SlabSize));
+                m_reservedBytes += SlabSize;
+                sizeClass.Slabs.emplace(slab, 0);
+                for (auto p = slab + SlabSize - SizeClasses[index]; p > slab; p -= SizeClasses[index])
+                    sizeClass.Free.emplace_back(p);
+                block = slab;
+            }
+            else
+            {
+                block = (byte*)operator new(SizeClasses[index]);
+                m_reservedBytes += SizeClasses[index];
+            }
+            if (IsSlabClass(index))
+                ++sizeClass.Slabs.at(GetSlab(block));
+        }
+        return Initialize(block, index, size);
+    }
+    void Deallocate(void* ptr)
+    {
+        if (!ptr)
+            return;
+
+        auto const header = (BlockHeader*)ptr - 1;
+        auto const block = (byte*)header;
+        if (header->SizeClass == DirectSizeClass)
+        {
+            {
+                std::scoped_lock _(m_directMutex);
+                --m_direct.LiveBlocks;
+                m_direct.LiveBytes -= header->Size;
+                m_reservedBytes -= sizeof(BlockHeader) + header->Size;
+            }
+            operator delete(block);
+            return;
+        }
+
+        auto const index = header->SizeClass;
+        auto& sizeClass = m_classes[index];
+        std::scoped_lock _(sizeClass.Mutex);
+        --sizeClass.LiveBlocks;
+        sizeClass.LiveBytes -= header->Size;
+        if (IsSlabClass(index))
+        {
+            --sizeClass.Slabs.at(GetSlab(block));
+            sizeClass.Free.emplace_back(block);
+        }
+        else if (ReserveCache(SizeClasses[index]))
+            sizeClass.Free.emplace_back(block);
+        else
+        {
+            m_reservedBytes -= SizeClasses[index];
+            operator delete(block);
+        }
+    }
+
+    // Releases cached large blocks and slabs that no longer have any live blocks
+    void Trim()
+    {
+        for (auto&& [index, sizeClass] : m_classes | std::views::enumerate)
+        {
+            std::scoped_lock _(sizeClass.Mutex);
+            if (IsSlabClass(index))
+            {
+                std::erase_if(sizeClass.Free, [&sizeClass](byte* block) { return !sizeClass.Slabs.at(GetSlab(block)); });
+                for (auto itr = sizeClass.Slabs.begin(); itr != sizeClass.Slabs.end(); )
+                {
+                    if (itr->second)
+                    {
+                        ++itr;
+                        continue;
+                    }
+                    operator delete(itr->first, std::align_val_t(SlabSize));
+                    m_reservedBytes -= SlabSize;
+                    itr = sizeClass.Slabs.erase(itr);
+                }
+            }
+            else
+            {
+                for (auto const block : sizeClass.Free)
+                    operator delete(block);
+                m_reservedBytes -= sizeClass.Free.size() * SizeClasses[index];
+                m_cachedBytes -= sizeClass.Free.size() * SizeClasses[index];
+                sizeClass.Free.clear();
+            }
+        }
+    }
+
+    [[nodiscard]] Stats GetStats() const
+    {
+        Stats stats { .ReservedBytes = m_reservedBytes, .CachedBytes = m_cachedBytes };
+        for (auto&& [index, sizeClass] : m_classes | std::views::enumerate)
+        {
+            std::scoped_lock _(sizeClass.Mutex);
+            stats.Classes.emplace_back(SizeClasses[index], sizeClass.Requests, sizeClass.Reused, sizeClass.LiveBlocks, sizeClass.LiveBytes, sizeClass.Free.size(), sizeClass.Slabs.size());
+        }
+        {
+            std::scoped_lock _(m_directMutex);
+            stats.Direct = m_direct;
+        }
+        return stats;
+    }
+
+private:
+    struct alignas(16) BlockHeader
+    {
+        uint32 SizeClass;
+        uint64 Size;
+    };
+    static_assert(sizeof(BlockHeader) == 16);
+
+    static constexpr uint32 DirectSizeClass = -1;
+    // Powers of two up to MaxSlabBlockSize carved from slabs, then four steps per power of two up to MaxCachedBlockSize
+    static constexpr auto SizeClasses = []
+    {
+        std::array<size_t, 7 + 12 * 4> sizes { };
+        size_t i = 0;
+        for (size_t size = 1 << 10; size <= MaxSlabBlockSize; size <<= 1)
+            sizes[i++] = size;
+        for (size_t size = MaxSlabBlockSize; size < MaxCachedBlockSize; size <<= 1)
+            for (size_t step = 1; step <= 4; ++step)
+                sizes[i++] = size + size / 4 * step;
+        return sizes;
+    }();
+    static_assert(SizeClasses.back() == MaxCachedBlockSize);
+
+    [[nodiscard]] static uint32 GetSizeClassIndex(size_t size)
+    {
+        auto const itr = std::ranges::lower_bound(SizeClasses, size);
+        return itr != SizeClasses.end() ? (uint32)std::distance(SizeClasses.begin(), itr) : DirectSizeClass;
+    }
+    [[nodiscard]] static void* Initialize(byte* block, uint32 index, size_t size) { return new(block) BlockHeader { index, size } + 1; }
+    [[nodiscard]] static bool IsSlabClass(size_t index) { return SizeClasses[index] <= MaxSlabBlockSize; }
+    [[nodiscard]] static byte* GetSlab(byte* block) { return (byte*)((uintptr_t)block & ~(SlabSize - 1)); }
+    // Size classes have separate locks, so the budget is claimed atomically to keep concurrent frees from overshooting it together
+    [[nodiscard]] bool ReserveCache(size_t size)
+    {
+        for (auto cached = m_cachedBytes.load(); cached + size <= CacheBudget; )
+            if (m_cachedBytes.compare_exchange_weak(cached, cached + size))
+                return true;
+        return false;
+    }
+
+    struct SizeClass
+    {
+        mutable std::mutex Mutex;
+        std::vector<byte*> Free;
+        std::unordered_map<byte*, uint32> Slabs;
+        size_t Requests = 0;
+        size_t Reused = 0;
+        size_t LiveBlocks = 0;
+        size_t LiveBytes = 0;
+    };
+    std::array<SizeClass, SizeClasses.size()> m_classes;
+    mutable std::mutex m_directMutex;
+    SizeClassStats m_direct { .BlockSize = MaxCachedBlockSize };
+    std::atomic<size_t> m_reservedBytes = 0;
+    std::atomic<size_t> m_cachedBytes = 0;
+};
+
+// Never destroyed, pack files owned by other globals can outlive any static allocator instance
+PackFileAllocator& GetPackFileAllocator() { static auto& instance = *new PackFileAllocator; return instance; }
+
+}
@@ -0,0 +1,13 @@
+export module GW2Viewer.Data.Pack.PackFile:Generated;
+import :Layout;
+import :Traversal;
+import GW2Viewer.Common;
+import std;
+
+export namespace GW2Viewer::Data::Pack::Layout::Generated
+{
+
+// Emits packed C++ structs with static_asserted sizes for a chunk version's discovered layout, to be pasted into hand-written loaders
+[[nodiscard]] std::string Generate(std::string_view chunk, uint32 version, bool x64);
+
+}
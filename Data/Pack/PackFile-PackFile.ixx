@@ -1,5 +1,6 @@
 export module GW2Viewer.Data.Pack.PackFile:PackFile;
 export import :Layout;
+import :Allocator;
 import GW2Viewer.Common;
 import GW2Viewer.Common.FourCC;
 import std;
@@ -47,10 +48,11 @@ struct PackFile
 
     static PackFile* Alloc(size_t size)
     {
-        auto* file = (PackFile*)operator new(size + sizeof(PackFileChunk::ChunkHeader));
-        memset(file, 0, size + sizeof(PackFileChunk::ChunkHeader));
+        auto* file = (PackFile*)GetPackFileAllocator().Allocate(size + sizeof(PackFileChunk::ChunkHeader));
+        memset((byte*)file + size, 0, sizeof(PackFileChunk::ChunkHeader)); // Only the terminating chunk needs zeroing, the rest is overwritten by the file contents
         return file;
     }
+    static void operator delete(void* ptr) { GetPackFileAllocator().Deallocate(ptr); }
 
     FileHeader Header; // hdr
     byte Data[];
@@ -1,7 +1,9 @@
 ﻿module GW2Viewer.Data.Pack.PackFile;
+import :Generated;
 import :Traversal;
 import GW2Viewer.Data.Game;
 import std;
+import <cctype>;
 
 namespace GW2Viewer::Data::Pack
 {
@@ -16,3 +18,119 @@ namespace GW2Viewer::Data::Pack::Layout::Traversal
 std::map<uint32, Type const*> const* GetChunk(std::string_view name) { return G::Game.Pack.GetChunk(name); }
 
 }
+
+namespace GW2Viewer::Data::Pack::Layout::Generated
+{
+
+std::string Generate(std::string_view chunkName, uint32 version, bool x64)
+{
+    auto const chunk = Traversal::GetChunk(chunkName);
+    if (!chunk)
+        throw std::exception("Generate() called for a chunk with unknown layout");
+    auto const itrVersion = chunk->find(version);
+    if (itrVersion == chunk->end())
+        throw std::exception("Generate() called for a chunk version with unknown layout");
+    Type const& root = *itrVersion->second;
+    chunkName = chunkName.substr(0, chunkName.find('\0'));
+
+    auto sanitize = [](std::string_view name)
+    {
+        std::string result { std::from_range, name | std::views::transform([](char c) { return isalnum((byte)c) ? c : '_'; }) };
+        if (result.empty() || isdigit((byte)result.front()))
+            result.insert(0, "_");
+        return result;
+    };
+    auto makeUnique = [&sanitize](std::string_view name, std::set<std::string, std::less<>>& used)
+    {
+        auto result = sanitize(name);
+        for (uint32 suffix = 2; !used.emplace(result).second; ++suffix)
+            result = std::format("{}_{}", sanitize(name), suffix);
+        return result;
+    };
+
+    // Pointers and arrays only need a forward declaration, so cycles through them are fine. Inline members are emitted before their parents.
+    std::unordered_map<Type const*, std::string> names;
+    std::set<std::string, std::less<>> usedNames;
+    std::vector<Type const*> order;
+    auto visit = [&](Type const& type, auto& visit) -> void
+    {
+        if (names.contains(&type))
+            return;
+        names.emplace(&type, makeUnique(type.Name, usedNames));
+        for (auto const& field : type.Fields)
+        {
+            if (field.ElementType)
+                visit(*field.ElementType, visit);
+            for (auto const* element : field.VariantElementTypes)
+                if (element)
+                    visit(*element, visit);
+        }
+        order.emplace_back(&type);
+    };
+    visit(root, visit);
+
+    std::string_view const pointer = x64 ? "int64" : "int32";
+    auto memberType = [&](Field const& field) -> std::string
+    {
+        std::string const element = field.ElementType ? names.at(field.ElementType) : "byte";
+        using enum UnderlyingTypes;
+        switch (field.UnderlyingType)
+        {
+            case Byte: return "byte";
+            case Byte3: return "std::array<byte, 3>";
+            case Byte4: return "std::array<byte, 4>";
+            case Byte16: return "std::array<byte, 16>";
+            case Word: return "uint16";
+            case Word3: return "std::array<uint16, 3>";
+            case Dword:
+            case DwordID: return "uint32";
+            case Dword2: return "std::array<uint32, 2>";
+            case Dword4: return "std::array<uint32, 4>";
+            case Qword:
+            case QwordID: return "uint64";
+            case Float: return "float";
+            case Float2: return "std::array<float, 2>";
+            case Float3: return "std::array<float, 3>";
+            case Float4: return "std::array<float, 4>";
+            case Double: return "double";
+            case Double2: return "std::array<double, 2>";
+            case Double3: return "std::array<double, 3>";
+            case FileName:
+            case FileName2: return std::format("FileNameBase<{}>", pointer);
+            case String: return std::format("String<{}>", pointer);
+            case WString: return std::format("WString<{}>", pointer);
+            case Ptr: return std::format("PtrBase<{}, {}>", element, pointer);
+            case Variant: return std::format("Variant<{}>", pointer);
+            case InlineStruct:
+            case InlineStruct2: return element;
+            case InlineArray: return std::format("std::array<{}, {}>", element, field.ArraySize);
+            case DwordArray: return std::format("ArrayBase<{}, uint32, {}>", element, pointer);
+            case WordArray: return std::format("ArrayBase<{}, uint16, {}>", element, pointer);
+            case ByteArray: return std::format("ArrayBase<{}, byte, {}>", element, pointer);
+            case DwordPtrArray: return std::format("ArrayBase<PtrBase<{0}, {1}>, uint32, {1}>", element, pointer);
+            case WordPtrArray: return std::format("ArrayBase<PtrBase<{0}, {1}>, uint16, {1}>", element, pointer);
+            case BytePtrArray: return std::format("ArrayBase<PtrBase<{0}, {1}>, byte, {1}>", element, pointer);
+            case DwordTypedArray: return std::format("TypedArrayBase<uint32, {}>", pointer);
+            case WordTypedArray: return std::format("TypedArrayBase<uint16, {}>", pointer);
+            case ByteTypedArray: return std::format("TypedArrayBase<byte, {}>", pointer);
+            default: throw std::exception("Generate() encountered a field of unsupported type");
+        }
+    };
+
+    std::string result = std::format("// Generated from chunk {} v{} ({})\n#pragma pack(push, 1)\n", chunkName, version, x64 ? "x64" : "x86");
+    for (auto const* type : order)
+        result += std::format("struct {};\n", names.at(type));
+    for (auto const* type : order)
+    {
+        std::set<std::string, std::less<>> usedMembers;
+        auto const& name = names.at(type);
+        result += std::format("struct {}\n{{\n", name);
+        for (auto const& field : type->Fields)
+            result += std::format("    {} {};\n", memberType(field), makeUnique(field.Name, usedMembers));
+        result += std::format("}};\nstatic_assert(sizeof({}) == {});\n", name, type->Size(x64));
+    }
+    result += "#pragma pack(pop)\n";
+    return result;
+}
+
+}
@@ -1,4 +1,6 @@
 export module GW2Viewer.Data.Pack.PackFile;
+export import :Allocator;
+export import :Generated;
 export import :Layout;
 export import :PackFile;
 export import :Traversal;
@@ -47,6 +47,7 @@ void Manager::LoadLanguage(Language language, Utils::Async::ProgressBarContext&
         m_stringsFiles[language].emplace_back(G::Game.Archive.GetFile(fileID), language, fileIndex, m_stringsPerFile);
         ++progress;
     }
+    ++m_version;
 }
 
 Manager::StringsFile::TCache const& Manager::GetStringImpl(uint32 stringID)
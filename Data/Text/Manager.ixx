@@ -21,6 +21,8 @@ public:
     void LoadLanguage(Language language, Utils::Async::ProgressBarContext& progress);
 
     auto GetMaxID() const { return m_maxID; }
+    // Changes whenever strings that were missing or encrypted before might have become readable
+    uint32 GetVersion() const { return m_version; }
     bool WipeCache(uint32 stringID)
     {
         if (stringID >= m_maxID)
@@ -33,6 +35,8 @@ public:
             if (fileIndex < files.size())
                 result |= files[fileIndex].Wipe(stringIndex);
 
+        if (result)
+            ++m_version;
         return result;
     }
     std::pair<std::wstring const*, Encryption::Status> Get(uint32 stringID)
@@ -183,6 +187,7 @@ private:
     };
     magic_enum::containers::array<Language, std::vector<StringsFile>> m_stringsFiles;
     magic_enum::containers::array<Language, bool> m_languageLoaded;
+    std::atomic<uint32> m_version = 0;
     StringsFile::TCache const& GetStringImpl(uint32 stringID);
     static std::wstring DecryptString(std::span<byte const> const encryptedText, uint64 const key, uint16 const decryptionOffset, uint32 const bitsPerSymbol)
     {
@@ -3,14 +3,17 @@
 #include <imgui_impl_dx11.h>
 #include <imgui_impl_win32.h>
 #include <d3d11.h>
+#include <shellapi.h>
 //#define DIRECTINPUT_VERSION 0x0800
 //#include <dinput.h>
 #include <tchar.h>
 
 import GW2Viewer.Data.Game;
 import GW2Viewer.System.Graphics;
+import GW2Viewer.Tasks.CommandLine;
 import GW2Viewer.UI.Manager;
 import GW2Viewer.User.Config;
+import std;
 
 void Render()
 {
@@ -94,6 +97,23 @@ int WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int n
 
     CoInitializeEx(nullptr, COINIT_MULTITHREADED);
 
+    // Batch operations write their status to the console they were started from, if any
+    int argc;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    std::vector<std::wstring> const args { argv + 1, argv + argc };
+    LocalFree(argv);
+    if (!args.empty() && AttachConsole(ATTACH_PARENT_PROCESS))
+    {
+        FILE* stream;
+        freopen_s(&stream, "CONOUT$", "w", stdout);
+        freopen_s(&stream, "CONOUT$", "w", stderr);
+    }
+    if (auto const exitCode = Tasks::CommandLine::Run(args))
+    {
+        CoUninitialize();
+        return *exitCode;
+    }
+
     // Create application window
     WNDCLASSEX wc =
     {
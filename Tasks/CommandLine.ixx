@@ -0,0 +1,169 @@
+export module GW2Viewer.Tasks.CommandLine;
+import GW2Viewer.Common;
+import GW2Viewer.Data.Archive;
+import GW2Viewer.Data.Content.ContentDiff;
+import GW2Viewer.Data.Content.QueryBatch;
+import GW2Viewer.Data.External.Database;
+import GW2Viewer.Data.Game;
+import GW2Viewer.User.Config;
+import GW2Viewer.Utils.Async.ProgressBarContext;
+import GW2Viewer.Utils.Encoding;
+import std;
+
+export namespace GW2Viewer::Tasks
+{
+
+// Runs content batch operations without creating any UI, so they can be scripted. Content is loaded with the settings saved by the viewer.
+//   --save-content-diff-snapshot [--output <snapshot.ndjson>]
+//   --diff-content <before.ndjson> [<after.ndjson>] [--output <diff.ndjson>]  Diffs against the loaded content unless a second snapshot is given
+//   --run-content-query-jobs <jobs.json> [--output <directory>]
+struct CommandLine
+{
+    // Returns the exit code if the arguments asked for a batch operation, or nothing if the viewer should start as usual
+    static std::optional<int> Run(std::span<std::wstring const> args)
+    {
+        if (args.empty() || !args.front().starts_with(L"--"))
+            return { };
+
+        Arguments arguments;
+        for (auto itr = std::next(args.begin()); itr != args.end(); ++itr)
+        {
+            if (*itr == L"--output" && std::next(itr) != args.end())
+                arguments.Output = *++itr;
+            else
+                arguments.Operands.emplace_back(*itr);
+        }
+
+        try
+        {
+            if (auto const& command = args.front(); command == L"--save-content-diff-snapshot" && arguments.Operands.empty())
+                return SaveContentDiffSnapshot(arguments);
+            else if (command == L"--diff-content" && (arguments.Operands.size() == 1 || arguments.Operands.size() == 2))
+                return DiffContent(arguments);
+            else if (command == L"--run-content-query-jobs" && arguments.Operands.size() == 1)
+                return RunContentQueryJobs(arguments);
+
+            std::cerr << std::format("Unknown command line: {}\n", Utils::Encoding::ToUTF8(args | std::views::join_with(L' ') | std::ranges::to<std::wstring>()));
+            return 1;
+        }
+        catch (std::exception const& exception)
+        {
+            std::cerr << std::format("Failed: {}\n", exception.what());
+            return 1;
+        }
+    }
+
+private:
+    struct Arguments
+    {
+        std::vector<std::filesystem::path> Operands;
+        std::optional<std::filesystem::path> Output;
+    };
+
+    static bool LoadContent(Utils::Async::ProgressBarContext& progress)
+    {
+        G::Config.Load();
+        if (G::Config.GameExePath.empty() || G::Config.GameDatPath.empty())
+        {
+            std::cerr << "Game paths have to be set in the viewer first\n";
+            return false;
+        }
+
+        for (auto const& [fileID, key] : G::Config.ContentFileKeys)
+            G::Game.Encryption.AddContentFileKey(fileID, key);
+        std::cerr << "Loading game\n";
+        G::Game.HashExecutable(G::Config.GameExePath, progress);
+        G::Game.Load(G::Config.GameExePath, progress);
+        if (!G::Config.DecryptionKeysPath.empty())
+            G::Database.Load(G::Config.DecryptionKeysPath, progress);
+        std::cerr << "Loading archives\n";
+        G::Game.Archive.Add(Data::Archive::Kind::Game, G::Config.GameDatPath);
+        if (!G::Config.LocalDatPath.empty())
+            G::Game.Archive.Add(Data::Archive::Kind::Local, G::Config.LocalDatPath);
+        G::Game.Archive.Load(progress);
+        std::cerr << "Loading text\n";
+        G::Game.Text.Load(progress);
+        G::Game.Text.LoadLanguage(G::Config.Language, progress);
+        std::cerr << "Loading content\n";
+        G::Game.Content.Load(progress);
+        if (!G::Game.Content.IsLoaded())
+        {
+            std::cerr << "Content files are still encrypted, their keys have to be entered in the viewer first\n";
+            return false;
+        }
+        if (G::Config.LastNumContentTypes && G::Config.LastNumContentTypes != G::Game.Content.GetNumTypes())
+        {
+            std::cerr << "Content types have changed, they have to be migrated in the viewer first\n";
+            return false;
+        }
+        return true;
+    }
+    static std::ofstream OpenOutput(std::filesystem::path const& path)
+    {
+        if (path.has_parent_path())
+            create_directories(path.parent_path());
+        std::ofstream output(path);
+        if (!output)
+            throw std::runtime_error(std::format("Can't write {}", path.string()));
+        return output;
+    }
+
+    static int SaveContentDiffSnapshot(Arguments const& arguments)
+    {
+        Utils::Async::ProgressBarContext progress;
+        if (!LoadContent(progress))
+            return 1;
+
+        auto const path = arguments.Output.value_or(Data::Content::ContentDiff::GetSnapshotPath(G::Game.Build));
+        auto output = OpenOutput(path);
+        Data::Content::ContentDiff::SaveSnapshot(G::Game.Content.GetTypes(), G::Game.Build, output, progress);
+        std::cerr << std::format("Saved content diff snapshot of build {} to {}\n", G::Game.Build, path.string());
+        return 0;
+    }
+    static int DiffContent(Arguments const& arguments)
+    {
+        Utils::Async::ProgressBarContext progress;
+        auto load = [&progress](std::filesystem::path const& path)
+        {
+            std::ifstream input(path);
+            auto snapshot = Data::Content::ContentDiff::LoadSnapshot(input, progress);
+            if (!snapshot)
+                throw std::runtime_error(std::format("Can't load content diff snapshot {}", path.string()));
+            return *std::move(snapshot);
+        };
+
+        auto const before = load(arguments.Operands[0]);
+        std::optional<Data::Content::ContentDiffSnapshot> after;
+        if (arguments.Operands.size() > 1)
+            after = load(arguments.Operands[1]);
+        else if (!LoadContent(progress))
+            return 1;
+
+        auto const afterBuild = after ? after->Build : G::Game.Build;
+        auto output = OpenOutput(arguments.Output.value_or(Data::Content::ContentDiff::GetDiffPath(before.Build, afterBuild)));
+        auto const [added, removed, changed, unchanged] = after
+            ? Data::Content::ContentDiff::Diff(before, *after, output, progress)
+            : Data::Content::ContentDiff::Diff(before, G::Game.Content.GetTypes(), output, progress);
+        std::cout << std::format("Content changes from build {} to {}:\n{} added, {} removed, {} changed, {} unchanged\n", before.Build, afterBuild, added, removed, changed, unchanged);
+        return 0;
+    }
+    static int RunContentQueryJobs(Arguments const& arguments)
+    {
+        Utils::Async::ProgressBarContext progress;
+        if (!LoadContent(progress))
+            return 1;
+
+        auto const& jobsPath = arguments.Operands[0];
+        auto const directory = arguments.Output.value_or(Data::Content::QueryBatch::GetDefaultOutputDirectory(jobsPath, G::Game.Build));
+        auto const jobs = Data::Content::QueryBatch::RunFile(jobsPath, directory, G::Game.Content.GetTypes(), progress);
+        if (!jobs)
+        {
+            std::cerr << std::format("Can't load content query jobs {}\n", jobsPath.string());
+            return 1;
+        }
+        std::cerr << std::format("Ran {} content query jobs from {} into {}\n", *jobs, jobsPath.filename().string(), directory.string());
+        return 0;
+    }
+};
+
+}
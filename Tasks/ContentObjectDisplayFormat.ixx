@@ -38,7 +38,12 @@ struct ContentObjectDisplayFormat
     [[nodiscard]] std::string Process(Data::Content::ContentObject const& object, std::string_view displayFormat) const;
 
 private:
-    [[nodiscard]] std::string Process(Data::Content::ContentObject const& object, char const*& pFormat, char const* pFormatEnd, bool inTernary = false) const;
+    class Program;
+    // Compiled once per type and recompiled whenever the type's display format changes
+    [[nodiscard]] std::shared_ptr<Program const> GetProgram(Data::Content::ContentObject const& object, std::string_view displayFormat) const;
+
+    mutable std::shared_mutex m_programsLock;
+    mutable std::unordered_map<uint32, std::shared_ptr<Program const>> m_programs;
 
     inline static thread_local boost::container::small_vector<Data::Content::ContentObject const*, 100> tls_recursionPrevention;
 };
@@ -122,217 +127,345 @@ char const* ContentObjectDisplayFormat::GetMarkupHelp() const
 }
 #undef CODE
 
-std::string ContentObjectDisplayFormat::Process(Data::Content::ContentObject const& content, std::string_view displayFormat) const
-{
-    auto pFormat = displayFormat.data();
-    auto name = Process(content, pFormat, pFormat + displayFormat.size());
-    name.shrink_to_fit();
-    return name;
-}
-std::string ContentObjectDisplayFormat::Process(Data::Content::ContentObject const& content, char const*& pFormat, char const* pFormatEnd, bool inTernary) const
+// A display format compiled into a flat instruction list. Ternary parts are compiled into blocks of their own, which the evaluation
+// pushes onto its block stack instead of recursing. Symbol paths are compiled once, array separators point into the owned copy of the format.
+class ContentObjectDisplayFormat::Program
 {
-    std::string display;
-    display.reserve(std::distance(pFormat, pFormatEnd) * 5);
+public:
+    explicit Program(std::string source) : m_source(std::move(source))
+    {
+        auto pFormat = m_source.data();
+        m_root = Compile(pFormat, pFormat + m_source.size());
+    }
+    Program(Program const&) = delete;
+    Program& operator=(Program const&) = delete;
+
+    [[nodiscard]] std::string_view GetSource() const { return m_source; }
+
+    void Evaluate(Data::Content::ContentObject const& content, std::string& display) const
+    {
+        boost::container::small_vector<Block, 8> stack { m_root };
+        while (!stack.empty())
+        {
+            auto& block = stack.back();
+            if (block.Begin == block.End)
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            switch (auto const& instruction = m_instructions[block.Begin++]; instruction.Op)
+            {
+                case OpCode::Literal:
+                    display.append(m_literals, instruction.Index, instruction.Count);
+                    break;
+                case OpCode::Expression:
+                    if (auto const next = EvaluateExpression(content, m_expressions[instruction.Index], display))
+                        stack.emplace_back(*next);
+                    break;
+            }
+        }
+    }
 
-    auto formatRemainder = [&](uint32 offset = 0) -> std::string_view { return { pFormat + offset, pFormatEnd }; };
-    auto readUntil = [&](std::string_view chars)
+private:
+    enum class OpCode : byte
+    {
+        Literal,    // Appends Count characters of the literal pool starting at Index
+        Expression, // Evaluates the expression at Index
+    };
+    struct Instruction
+    {
+        OpCode Op;
+        uint32 Index;
+        uint32 Count;
+    };
+    struct Block
+    {
+        uint32 Begin;
+        uint32 End;
+    };
+    struct Alternative
+    {
+        Data::Content::CompiledSymbolPath const* Path;
+        bool Array;
+        std::string_view ArraySeparator;
+    };
+    struct Expression
     {
-        auto result = formatRemainder();
-        if (auto const charPos = result.find_first_of(chars); charPos != std::string::npos)
-            result = { pFormat, charPos };
-        pFormat += result.size();
-        return result;
+        uint32 FirstAlternative;
+        uint32 NumAlternatives;
+        std::optional<Block> True;
+        std::optional<Block> False;
     };
 
-    while (pFormat < pFormatEnd)
+    std::string const m_source;
+    std::string m_literals;
+    std::vector<Instruction> m_instructions;
+    std::vector<Alternative> m_alternatives;
+    std::vector<Expression> m_expressions;
+    Block m_root { };
+
+    Block Compile(char const*& pFormat, char const* pFormatEnd, bool inTernary = false)
     {
-        switch (*pFormat)
+        std::vector<Instruction> block;
+        auto finish = [&]
+        {
+            Block const result { (uint32)m_instructions.size(), (uint32)(m_instructions.size() + block.size()) };
+            m_instructions.append_range(block);
+            return result;
+        };
+        auto appendLiteral = [&](std::string_view text)
         {
-            case '{': // Parse expression
+            if (text.empty())
+                return;
+            // Literals separated only by escapes and ignored line breaks end up adjacent in the pool and can share an instruction
+            if (!block.empty() && block.back().Op == OpCode::Literal && block.back().Index + block.back().Count == m_literals.size())
+                block.back().Count += (uint32)text.size();
+            else
+                block.emplace_back(OpCode::Literal, (uint32)m_literals.size(), (uint32)text.size());
+            m_literals.append(text);
+        };
+        auto formatRemainder = [&](uint32 offset = 0) -> std::string_view { return { pFormat + offset, pFormatEnd }; };
+        auto readUntil = [&](std::string_view chars)
+        {
+            auto result = formatRemainder();
+            if (auto const charPos = result.find_first_of(chars); charPos != std::string::npos)
+                result = { pFormat, charPos };
+            pFormat += result.size();
+            return result;
+        };
+
+        while (pFormat < pFormatEnd)
+        {
+            switch (*pFormat)
             {
-                ++pFormat;
-                struct Alternative
+                case '{': // Parse expression
                 {
-                    std::string_view Path;
-                    bool Array = false;
-                    std::string_view ArraySeparator = Path.ends_with("->@icon") ? "" : ", ";
-                };
-                boost::container::small_vector<Alternative, 5> alternatives;
-                std::optional<std::string> trueText, falseText;
+                    ++pFormat;
+                    struct ParsedAlternative
+                    {
+                        std::string_view Path;
+                        bool Array = false;
+                        std::string_view ArraySeparator = Path.ends_with("->@icon") ? "" : ", ";
+                    };
+                    boost::container::small_vector<ParsedAlternative, 5> alternatives;
+                    std::optional<Block> trueBlock, falseBlock;
 
-            parseName:
-                auto& alternative = alternatives.emplace_back(readUntil("}|[?\n"));
+                parseName:
+                    auto& alternative = alternatives.emplace_back(readUntil("}|[?\n"));
 
-                while (pFormat < pFormatEnd)
-                {
-                    switch (*pFormat)
+                    while (pFormat < pFormatEnd)
                     {
-                        case '}': // End of expression
-                            goto endParseExpression;
-                        case '|': // Parse alternative
-                            ++pFormat;
-                            goto parseName;
-                        case '[': // Parse array
-                            if (pFormat[1] == ']')
-                            {
-                                alternative.Array = true;
-                                pFormat += 2;
-                                // Parse array separator
-                                if (auto const separatorEnd = formatRemainder().find("..."); separatorEnd != std::string::npos)
+                        switch (*pFormat)
+                        {
+                            case '}': // End of expression
+                                goto endParseExpression;
+                            case '|': // Parse alternative
+                                ++pFormat;
+                                goto parseName;
+                            case '[': // Parse array
+                                if (pFormat[1] == ']')
                                 {
-                                    alternative.ArraySeparator = { pFormat, pFormat + separatorEnd };
-                                    pFormat += alternative.ArraySeparator.size() + 3;
-                                }
-                                continue;
-                            }
-                            // Unexpected character
-                            break;
-                        case '?': // Ternary expression - parse true part
-                            ++pFormat;
-                            trueText = Process(content, pFormat, pFormatEnd, true);
-                            switch (*pFormat)
-                            {
-                                case ':': // Parse false part
-                                    ++pFormat;
-                                    falseText = Process(content, pFormat, pFormatEnd, true);
-                                    switch (*pFormat)
+                                    alternative.Array = true;
+                                    pFormat += 2;
+                                    // Parse array separator
+                                    if (auto const separatorEnd = formatRemainder().find("..."); separatorEnd != std::string::npos)
                                     {
-                                        case '}':
-                                        case '|':
-                                        case '[':
-                                        case '\0':
-                                            continue;
-                                        default: // Unexpected character
-                                            break;
+                                        alternative.ArraySeparator = { pFormat, pFormat + separatorEnd };
+                                        pFormat += alternative.ArraySeparator.size() + 3;
                                     }
-                                    break;
-                                case '}':
-                                case '|':
-                                case '[':
-                                case '\0':
                                     continue;
-                                default: // Unexpected character
-                                    break;
-                            }
-                            break;
-                        case '\n': // Ignore newline
-                            ++pFormat;
-                            continue;
+                                }
+                                // Unexpected character
+                                break;
+                            case '?': // Ternary expression - parse true part
+                                ++pFormat;
+                                trueBlock = Compile(pFormat, pFormatEnd, true);
+                                switch (*pFormat)
+                                {
+                                    case ':': // Parse false part
+                                        ++pFormat;
+                                        falseBlock = Compile(pFormat, pFormatEnd, true);
+                                        switch (*pFormat)
+                                        {
+                                            case '}':
+                                            case '|':
+                                            case '[':
+                                            case '\0':
+                                                continue;
+                                            default: // Unexpected character
+                                                break;
+                                        }
+                                        break;
+                                    case '}':
+                                    case '|':
+                                    case '[':
+                                    case '\0':
+                                        continue;
+                                    default: // Unexpected character
+                                        break;
+                                }
+                                break;
+                            case '\n': // Ignore newline
+                                ++pFormat;
+                                continue;
+                        }
+                        // Unexpected character
+                        appendLiteral(std::format("<c=#F00>{}</c>", *pFormat));
+                        ++pFormat;
                     }
-                    // Unexpected character
-                    display.append(std::format("<c=#F00>{}</c>", *pFormat));
-                    ++pFormat;
-                }
 
-            endParseExpression:
-                if (pFormat >= pFormatEnd)
-                {
-                    display.append("<c=#F00>" ICON_FA_EMPTY_SET "</c>");
-                    return display;
-                }
-                ++pFormat;
-
-                // Process expression
-                bool exists = false;
-                bool first = true;
-                bool wasEncrypted = false;
-                static auto const encryptedText = Data::Encryption::GetStatusText(Data::Encryption::Status::Encrypted);
-                for (auto const& alternative : alternatives)
-                {
-                    if (alternative.Path.empty())
-                        continue;
+                endParseExpression:
+                    if (pFormat >= pFormatEnd)
+                    {
+                        appendLiteral("<c=#F00>" ICON_FA_EMPTY_SET "</c>");
+                        return finish();
+                    }
+                    ++pFormat;
 
-                    for (auto& result : Data::Content::QuerySymbolData(content, alternative.Path))
+                    auto& expression = m_expressions.emplace_back((uint32)m_alternatives.size(), 0, trueBlock, falseBlock);
+                    for (auto const& [path, array, arraySeparator] : alternatives)
                     {
-                        exists = true;
-
-                        std::string value;
-                        auto const symbolType = result.Symbol.GetType();
-                        auto const resultContent = symbolType->GetContent(result).value_or(nullptr);
-                        if (resultContent == &content)
-                            value = "<c=#F00>RECURSION</c>";
-                        else if (auto text = symbolType->GetDisplayText(result); !text.empty())
-                            value = std::move(text);
-                        else if (resultContent)
-                            value = Utils::Encoding::ToUTF8(resultContent->GetDisplayName(false, true));
-
-                        if (value == encryptedText)
-                        {
-                            wasEncrypted = true;
+                        if (path.empty())
                             continue;
-                        }
 
-                        if (!value.empty())
-                        {
-                            // Append the true part of the ternary expression
-                            if (trueText)
-                            {
-                                display.append(*trueText);
-                                goto endProcessExpression;
-                            }
-                            // Append array separator
-                            if (alternative.Array && !first)
-                                display.append(alternative.ArraySeparator);
-                            first = false;
-                            // Append the yielded result
-                            display.append(wasEncrypted ? encryptedText + value : value);
-                            // Stop processing expression if we're not printing a whole array
-                            if (!alternative.Array)
-                                break;
-                        }
+                        m_alternatives.emplace_back(&Data::Content::CompileSymbolPath(path), array, arraySeparator);
+                        ++expression.NumAlternatives;
                     }
-                    // Stop processing alternate fields if one of them yielded a result
-                    if (!first)
-                        break;
+                    block.emplace_back(OpCode::Expression, (uint32)m_expressions.size() - 1, 0);
+                    break;
                 }
-                // Append the result of the ternary expression (true part if anything matched even if no result was yielded, false part if nothing matched)
-                if (first)
-                    if (auto const& text = exists ? trueText : falseText)
-                        display.append(*text);
-
-            endProcessExpression:
-                break;
+                case ':': // Process possible end of true part of the ternary expression or append literal character
+                    if (inTernary)
+                        return finish(); // End parsing current part of the ternary expression
+                    // Append literal character
+                    appendLiteral({ pFormat, 1 });
+                    ++pFormat;
+                    break;
+                case '}': // Process end of expression
+                    if (inTernary)
+                        return finish(); // End parsing current part of the ternary expression
+                    // Unexpected end of expression
+                    appendLiteral(std::format("<c=#F00>{}</c>", *pFormat));
+                    ++pFormat;
+                    break;
+                case '\\': // Process escape sequence
+                    switch (pFormat[1])
+                    {
+                        case '\0': // Unexpected EOL after the start of the escape sequence
+                            appendLiteral(std::format("<c=#F00>{0}{0}</c>", *pFormat));
+                            ++pFormat;
+                            break;
+                        case 'n': // Append newline
+                            appendLiteral("\n");
+                            pFormat += 2;
+                            break;
+                        default: // Append literal
+                            appendLiteral({ pFormat + 1, 1 });
+                            pFormat += 2;
+                            break;
+                    }
+                    break;
+                case '\n': // Ignore newline
+                    ++pFormat;
+                    break;
+                default: // Append literal text
+                    appendLiteral(readUntil("{:}\\\n"));
+                    break;
             }
-            case ':': // Process possible end of true part of the ternary expression or append literal character
-                if (inTernary)
-                    return display; // End parsing current part of the ternary expression
-                // Append literal character
-                display.push_back(*pFormat);
-                ++pFormat;
-                break;
-            case '}': // Process end of expression
-                if (inTernary)
-                    return display; // End parsing current part of the ternary expression
-                // Unexpected end of expression
-                display.append(std::format("<c=#F00>{}</c>", *pFormat));
-                ++pFormat;
-                break;
-            case '\\': // Process escape sequence
-                switch (pFormat[1])
+        }
+        return finish();
+    }
+
+    // Appends the expression's result, or returns the ternary part that has to be evaluated in its place
+    std::optional<Block> EvaluateExpression(Data::Content::ContentObject const& content, Expression const& expression, std::string& display) const
+    {
+        bool exists = false;
+        bool first = true;
+        bool wasEncrypted = false;
+        bool matchedTrue = false;
+        static auto const encryptedText = Data::Encryption::GetStatusText(Data::Encryption::Status::Encrypted);
+        for (auto const& alternative : std::span(m_alternatives).subspan(expression.FirstAlternative, expression.NumAlternatives))
+        {
+            alternative.Path->ForEach(content, [&](Data::Content::QuerySymbolDataResult const& result)
+            {
+                exists = true;
+
+                std::string value;
+                auto const symbolType = result.Symbol.GetType();
+                auto const resultContent = symbolType->GetContent(result).value_or(nullptr);
+                if (resultContent == &content)
+                    value = "<c=#F00>RECURSION</c>";
+                else if (auto text = symbolType->GetDisplayText(result); !text.empty())
+                    value = std::move(text);
+                else if (resultContent)
+                    value = Utils::Encoding::ToUTF8(resultContent->GetDisplayName(false, true));
+
+                if (value == encryptedText)
                 {
-                    case '\0': // Unexpected EOL after the start of the escape sequence
-                        display.append(std::format("<c=#F00>{0}{0}</c>", *pFormat));
-                        ++pFormat;
-                        break;
-                    case 'n': // Append newline
-                        display.push_back('\n');
-                        pFormat += 2;
-                        break;
-                    default: // Append literal
-                        display.push_back(pFormat[1]);
-                        pFormat += 2;
-                        break;
+                    wasEncrypted = true;
+                    return true;
                 }
-                break;
-            case '\n': // Ignore newline
-                ++pFormat;
-                break;
-            default: // Append literal text
-                display.append(readUntil("{:}\\\n"));
+
+                if (!value.empty())
+                {
+                    // Evaluate the true part of the ternary expression instead
+                    if (expression.True)
+                        return matchedTrue = true, false;
+                    // Append array separator
+                    if (alternative.Array && !first)
+                        display.append(alternative.ArraySeparator);
+                    first = false;
+                    // Append the yielded result
+                    if (wasEncrypted)
+                        display.append(encryptedText);
+                    display.append(value);
+                    // Stop processing expression if we're not printing a whole array
+                    if (!alternative.Array)
+                        return false;
+                }
+                return true;
+            });
+            if (matchedTrue)
+                return expression.True;
+            // Stop processing alternate fields if one of them yielded a result
+            if (!first)
                 break;
         }
+        // Evaluate the ternary expression (true part if anything matched even if no result was yielded, false part if nothing matched)
+        if (first)
+            return exists ? expression.True : expression.False;
+        return { };
+    }
+};
+
+std::shared_ptr<ContentObjectDisplayFormat::Program const> ContentObjectDisplayFormat::GetProgram(Data::Content::ContentObject const& object, std::string_view displayFormat) const
+{
+    {
+        std::shared_lock _(m_programsLock);
+        if (auto const itr = m_programs.find(object.Type->Index); itr != m_programs.end() && itr->second->GetSource() == displayFormat)
+            return itr->second;
     }
-    return display;
+
+    auto program = std::make_shared<Program const>(std::string(displayFormat));
+    std::unique_lock _(m_programsLock);
+    return m_programs.insert_or_assign(object.Type->Index, std::move(program)).first->second;
+}
+
+std::string ContentObjectDisplayFormat::Process(Data::Content::ContentObject const& content, std::string_view displayFormat) const
+{
+    // Nested display names are processed while the outer one is still being built, so each nesting level gets a buffer of its own
+    thread_local std::deque<std::string> buffers;
+    thread_local uint32 depth = 0;
+    if (buffers.size() <= depth)
+        buffers.emplace_back();
+    auto& buffer = buffers[depth];
+    buffer.clear();
+
+    ++depth;
+    auto const _ = gsl::finally([] { --depth; });
+    GetProgram(content, displayFormat)->Evaluate(content, buffer);
+    return buffer;
 }
 
 }
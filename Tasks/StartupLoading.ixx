@@ -35,6 +35,7 @@ struct StartupLoading
         Encryption,
         Event,
         GameBuild,
+        GameKey,
         GameRefs,
         Manifest,
         PackFileLayout,
@@ -53,11 +54,23 @@ struct StartupLoading
             .Provides = { Config },
             .Handler = [](ProgressBarContext& progress)
             {
+                for (auto const& [fileID, key] : G::Config.ContentFileKeys)
+                    G::Game.Encryption.AddContentFileKey(fileID, key);
             }
         });
         AddTask({
-            .Description = "Loading game",
+            .Description = "Hashing game",
             .Requires = { Config },
+            .Provides = { GameKey },
+            .Handler = [](ProgressBarContext& progress)
+            {
+                if (!G::Config.GameExePath.empty())
+                    G::Game.HashExecutable(G::Config.GameExePath, progress);
+            }
+        });
+        AddTask({
+            .Description = "Loading game",
+            .Requires = { Config, GameKey },
             .Provides = { GameBuild, GameRefs },
             .Handler = [](ProgressBarContext& progress)
             {
@@ -67,12 +80,12 @@ struct StartupLoading
         });
         AddTask({
             .Description = "Loading pack file definitions",
-            .Requires = { Config },
+            .Requires = { Config, GameKey },
             .Provides = { PackFileLayout },
             .Handler = [](ProgressBarContext& progress)
             {
                 if (!G::Config.GameExePath.empty())
-                    G::Game.Pack.Load(G::Config.GameExePath, progress);
+                    G::Game.Pack.Load(G::Config.GameExePath, G::Game.ExecutableKey, progress);
             }
         });
         AddTask({
@@ -153,6 +166,7 @@ struct StartupLoading
             .Description = "Loading content",
             .Requires = { Archive, Config },
             .Provides = { Content },
+            .Completed = [] { return G::Game.Content.IsLoaded(); }, // Retried once the keys of content files that are still encrypted are entered
             .Handler = [](ProgressBarContext& progress)
             {
                 G::Game.Content.Load(progress);
@@ -172,6 +186,23 @@ struct StartupLoading
                 }
             }
         });
+        AddTask({
+            .Description = "Indexing content names",
+            .Requires = { Content },
+            .RerunOn = { Encryption, TextLanguage },
+            .Handler = [](ProgressBarContext& progress)
+            {
+                G::Game.Content.BuildNameIndex(progress);
+            }
+        });
+        AddTask({
+            .Description = "Indexing content symbol values",
+            .Requires = { Content },
+            .Handler = [](ProgressBarContext& progress)
+            {
+                G::Game.Content.BuildSymbolValueIndex(progress);
+            }
+        });
         AddTask({
             .Description = "Building file list",
             .Requires = { GameBuild, Archive, ArchiveIndex },
@@ -226,10 +257,27 @@ struct StartupLoading
         std::vector<Tag> Provides;
         std::vector<Tag> RerunOn;
         std::function<bool()> Condition = [] { return true; };
+        std::function<bool()> Completed = [] { return true; }; // Checked after the handler ran, the tags are only provided if it completed
         std::function<void(Utils::Async::ProgressBarContext& progress)> Handler;
     };
 
     bool IsLoaded(Tag tag) const { return m_providedTags[tag]; }
+    bool IsRunning(Tag tag)
+    {
+        std::scoped_lock lock(m_mutex);
+        return std::ranges::any_of(m_scheduledTasks, [tag](ScheduledTask const& task) { return task.Running && std::ranges::contains(task.Task.Provides, tag); });
+    }
+    // Runs the tasks that should have provided the tag again, if they didn't complete
+    void Retry(Tag tag)
+    {
+        std::scoped_lock lock(m_mutex);
+        if (m_providedTags[tag])
+            return;
+
+        for (auto& task : m_scheduledTasks)
+            if (!task.Running && std::ranges::contains(task.Task.Provides, tag))
+                task.Started = false;
+    }
 
     void AddTask(Task task)
     {
@@ -306,8 +354,9 @@ private:
             run->Progress.ShowNotification().Run([this, run = run.get()](Utils::Async::ProgressBarContext& progress)
             {
                 run->ScheduledTask.Task.Handler(progress);
-                for (auto const& tag : run->ScheduledTask.Task.Provides)
-                    ProvideTag(tag);
+                if (run->ScheduledTask.Task.Completed())
+                    for (auto const& tag : run->ScheduledTask.Task.Provides)
+                        ProvideTag(tag);
                 run->ScheduledTask.Running = false;
             });
             return;
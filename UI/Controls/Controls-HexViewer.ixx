@@ -272,7 +272,7 @@ struct HexViewerOptions
     std::optional<uint32> OutHighlightOffset;
     std::optional<byte const*> OutHighlightPointer;
     std::map<uint32, HexViewerCellInfo> OutOffsetInfo;
-    byte const* ByteMap = nullptr;
+    std::function<GW2Viewer::byte(uint32 offset)> ByteMap;
 };
 void HexViewer(std::span<byte const> data, HexViewerOptions& options)
 {
@@ -431,7 +431,7 @@ void HexViewer(std::span<byte const> data, HexViewerOptions& options)
                         itr->second = { absoluteOffset, cursor, BYTE_SIZE, tableCursor, tableSize };
 
                 if (options.ByteMap)
-                    if (auto const color = BYTE_MAP_COLORS[options.ByteMap[absoluteOffset]])
+                    if (auto const color = BYTE_MAP_COLORS[options.ByteMap(absoluteOffset)])
                         I::GetWindowDrawList()->AddRectFilled(cursor, cursor + BYTE_SIZE, color);
 
                 if (scoped::ItemTooltip(ImGuiHoveredFlags_DelayNone))
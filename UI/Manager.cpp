@@ -6,9 +6,13 @@
 module GW2Viewer.UI.Manager;
 import GW2Viewer.Common.Time;
 import GW2Viewer.Content;
+import GW2Viewer.Data.Content.ContentDiff;
+import GW2Viewer.Data.Content.QueryBatch;
+import GW2Viewer.Data.Content.Manager;
 import GW2Viewer.Data.Encryption.Asset;
 import GW2Viewer.Data.Encryption.RC4;
 import GW2Viewer.Data.Game;
+import GW2Viewer.Data.Pack.PackFile;
 import GW2Viewer.Tasks.StartupLoading;
 import GW2Viewer.UI.ImGui;
 import GW2Viewer.UI.Notifications;
@@ -21,10 +25,12 @@ import GW2Viewer.UI.Windows.ArchiveIndex;
 import GW2Viewer.UI.Windows.Demangle;
 import GW2Viewer.UI.Windows.MigrateContentTypes;
 import GW2Viewer.UI.Windows.Notes;
+import GW2Viewer.UI.Windows.PackFileAllocator;
 import GW2Viewer.UI.Windows.Parse;
 import GW2Viewer.UI.Windows.Settings;
 import GW2Viewer.UI.Windows.Window;
 import GW2Viewer.User.Config;
+import GW2Viewer.Utils.Async.ProgressBarContext;
 import GW2Viewer.Utils.Base64;
 import std;
 import magic_enum;
@@ -264,6 +270,7 @@ void Manager::Update()
             I::MenuItem("Open Demangle Window", nullptr, &G::Windows::Demangle.GetShown());
             I::MenuItem("Open Archive Index Window", nullptr, &G::Windows::ArchiveIndex.GetShown());
             I::MenuItem("Open Notes Window", nullptr, &G::Windows::Notes.GetShown());
+            I::MenuItem("Open PackFile Allocator Window", nullptr, &G::Windows::PackFileAllocator.GetShown());
             I::MenuItem("Open Settings Window", nullptr, &G::Windows::Settings.GetShown());
             I::PopItemFlag();
         }
@@ -282,6 +289,105 @@ void Manager::Update()
                     if (auto data = G::Game.Archive.GetFile(fileID); !data.empty())
                         ExportData(data, std::format(R"(Export\Game Content\cntc\{}\{}.cntc)", G::Game.Build, fileID));
             I::MenuItem("Migrate Content Types", nullptr, &G::Windows::MigrateContentTypes.GetShown());
+            if (auto const encrypted = G::Game.Content.GetEncryptedFileIDs(); scoped::Menu("Content File Keys", !encrypted.empty()))
+            {
+                for (auto const fileID : encrypted)
+                {
+                    if (auto key = G::Game.Encryption.GetContentFileKey(fileID).value_or(0); I::InputScalar(std::format("File {}", fileID).c_str(), ImGuiDataType_U64, &key))
+                    {
+                        G::Config.ContentFileKeys[fileID] = key;
+                        G::Game.Encryption.AddContentFileKey(fileID, key);
+                    }
+                }
+                if (I::MenuItem("Resume Loading", nullptr, false, !G::Tasks::StartupLoading.IsRunning(Tasks::StartupLoading::Tag::Content)))
+                    G::Tasks::StartupLoading.Retry(Tasks::StartupLoading::Tag::Content);
+            }
+            static Utils::Async::ProgressBarContext verifyContentProcessing;
+            if (I::MenuItem("Verify Parallel Content Processing", nullptr, false, G::Game.Content.IsLoaded() && !verifyContentProcessing.IsRunning()))
+            {
+                verifyContentProcessing.Run([](Utils::Async::ProgressBarContext& progress)
+                {
+                    auto const serial = std::make_unique<Data::Content::Manager>();
+                    serial->Load(progress, false);
+                    auto const expected = serial->GetGraphHash();
+                    auto const actual = G::Game.Content.GetGraphHash();
+                    G::Notifications.AddCloseable({ .Text = expected == actual
+                        ? std::format("Content graph matches serial processing: {:016X}", actual)
+                        : std::format("Content graph differs from serial processing:\nParallel: {:016X}\nSerial: {:016X}", actual, expected) });
+                }).ShowNotification();
+            }
+            static Utils::Async::ProgressBarContext benchmarkContentLookupTables;
+            if (I::MenuItem("Benchmark Content Lookup Tables", nullptr, false, G::Game.Content.IsLoaded() && !benchmarkContentLookupTables.IsRunning()))
+            {
+                benchmarkContentLookupTables.Run([](Utils::Async::ProgressBarContext& progress)
+                {
+                    progress.Start("Benchmarking content lookup tables");
+                    G::Notifications.AddCloseable({ .Text = G::Game.Content.BenchmarkLookupTables() });
+                }).ShowNotification();
+            }
+            static Utils::Async::ProgressBarContext benchmarkContentObjectLookups;
+            if (I::MenuItem("Benchmark Content Object Lookups", nullptr, false, G::Game.Content.IsLoaded() && !benchmarkContentObjectLookups.IsRunning()))
+            {
+                benchmarkContentObjectLookups.Run([](Utils::Async::ProgressBarContext& progress)
+                {
+                    progress.Start("Benchmarking content object lookups");
+                    G::Notifications.AddCloseable({ .Text = G::Game.Content.BenchmarkObjectLookups() });
+                }).ShowNotification();
+            }
+            static Utils::Async::ProgressBarContext contentDiff;
+            if (I::MenuItem("Save Content Diff Snapshot", nullptr, false, G::Game.Content.IsLoaded() && !contentDiff.IsRunning()))
+            {
+                contentDiff.Run([](Utils::Async::ProgressBarContext& progress)
+                {
+                    auto const path = Data::Content::ContentDiff::GetSnapshotPath(G::Game.Build);
+                    create_directories(path.parent_path());
+                    std::ofstream file(path);
+                    Data::Content::ContentDiff::SaveSnapshot(G::Game.Content.GetTypes(), G::Game.Build, file, progress);
+                    G::Notifications.AddCloseable({ .Text = std::format("Saved content diff snapshot of build {}", G::Game.Build) });
+                }).ShowNotification();
+            }
+            if (scoped::Menu("Diff Content Against Snapshot", G::Game.Content.IsLoaded() && !contentDiff.IsRunning()))
+            {
+                std::error_code error;
+                for (auto const& entry : std::filesystem::directory_iterator(Data::Content::ContentDiff::SnapshotsDirectory, error))
+                {
+                    if (entry.path().extension() != ".ndjson" || !I::MenuItem(entry.path().stem().string().c_str()))
+                        continue;
+
+                    contentDiff.Run([snapshotPath = entry.path()](Utils::Async::ProgressBarContext& progress)
+                    {
+                        std::ifstream input(snapshotPath);
+                        auto const before = Data::Content::ContentDiff::LoadSnapshot(input, progress);
+                        if (!before)
+                        {
+                            G::Notifications.AddCloseable({ .Text = std::format("Failed to load content diff snapshot {}", snapshotPath.string()) });
+                            return;
+                        }
+
+                        std::ofstream output(Data::Content::ContentDiff::GetDiffPath(before->Build, G::Game.Build));
+                        auto const [added, removed, changed, unchanged] = Data::Content::ContentDiff::Diff(*before, G::Game.Content.GetTypes(), output, progress);
+                        G::Notifications.AddCloseable({ .Text = std::format("Content changes from build {} to {}:\n{} added, {} removed, {} changed, {} unchanged", before->Build, G::Game.Build, added, removed, changed, unchanged) });
+                    }).ShowNotification();
+                }
+            }
+            static Utils::Async::ProgressBarContext contentQueryJobs;
+            if (scoped::Menu("Run Content Query Jobs", G::Game.Content.IsLoaded() && !contentQueryJobs.IsRunning()))
+            {
+                std::error_code error;
+                for (auto const& entry : std::filesystem::directory_iterator("Queries", error))
+                {
+                    if (entry.path().extension() != ".json" || !I::MenuItem(entry.path().stem().string().c_str()))
+                        continue;
+
+                    contentQueryJobs.Run([jobsPath = entry.path()](Utils::Async::ProgressBarContext& progress)
+                    {
+                        if (auto const jobs = Data::Content::QueryBatch::RunFile(jobsPath, Data::Content::QueryBatch::GetDefaultOutputDirectory(jobsPath, G::Game.Build), G::Game.Content.GetTypes(), progress))
+                            G::Notifications.AddCloseable({ .Text = std::format("Ran {} content query jobs from {}", *jobs, jobsPath.filename().string()) });
+                        else
+                            G::Notifications.AddCloseable({ .Text = std::format("Failed to load content query jobs {}", jobsPath.string()) });
+                    }).ShowNotification();
+                }
+            }
         }
         I::Text("<c=#8>Gw2: %u</c>", G::Game.Build);
     }
@@ -336,6 +442,7 @@ void Manager::Update()
             }
 
             viewers.erase(std::ranges::find(viewers, *toRemove));
+            Data::Pack::GetPackFileAllocator().Trim();
         }
     };
     drawViewers(m_listViewers, left);
@@ -343,6 +450,7 @@ void Manager::Update()
 
     G::Notifications.Draw();
     G::Game.Texture.UploadToGPU();
+    G::Game.Content.UpdateDisplayNames();
     G::Tasks::StartupLoading.Run();
 }
 
@@ -58,7 +58,7 @@ struct ContentListViewer : ListViewer<ContentListViewer, { ICON_FA_FOLDER_TREE "
         std::mutex& Lock;
         bool SortPending;
     };
-    SortedContentObjects GetSortedContentObjects(bool isNamespace, uint32 index, std::vector<Data::Content::ContentObject const*> const& entries)
+    SortedContentObjects GetSortedContentObjects(bool isNamespace, uint32 index, std::span<Data::Content::ContentObject const* const> entries)
     {
         struct Cache
         {
@@ -92,7 +92,7 @@ struct ContentListViewer : ListViewer<ContentListViewer, { ICON_FA_FOLDER_TREE "
         auto& cache = (isNamespace ? namespaces : rootObjects)[index];
         if (std::scoped_lock _(cache.Lock); cache.Objects.size() != entries.size())
         {
-            cache.Objects = entries;
+            cache.Objects.assign_range(entries);
             cache.Reset = true;
             cache.Ready = false;
         }
@@ -238,6 +238,13 @@ struct ContentListViewer : ListViewer<ContentListViewer, { ICON_FA_FOLDER_TREE "
                 CHECK_ASYNC;
             }
 
+            CHECK_ASYNC;
+            if (!filter.NameSearch.empty())
+            {
+                G::Game.Content.UpdateNameIndex();
+                if (auto candidates = G::Game.Content.GetNameCandidates(filter.NameSearch))
+                    filter.NameCandidates = std::move(*candidates);
+            }
             CHECK_ASYNC;
             filter.FilteredNamespaces.resize(G::Game.Content.GetNamespaces().size(), Data::Content::ContentFilter::UNCACHED_RESULT);
             CHECK_ASYNC;
@@ -926,7 +933,10 @@ private:
                 {
                     I::Text("Full Name: %s", Utils::Encoding::ToUTF8(entry.GetFullName()).c_str());
                     if (I::InputTextUTF8("Name", G::Config.ContentObjectNames, *entry.GetGUID(), entry.GetName() && entry.GetName()->Name && *entry.GetName()->Name ? *entry.GetName()->Name : entry.GetDisplayName()))
+                    {
+                        Data::Content::DisplayNameCache::NotifyCustomNameChanged();
                         ClearCache();
+                    }
 
                     Controls::CopyButton("GUID", entry.GetGUID() ? *entry.GetGUID() : GUID::Empty, entry.GetGUID());
                     I::SameLine();
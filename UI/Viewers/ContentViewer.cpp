@@ -74,7 +74,10 @@ void ContentViewer::Draw()
                 if (scoped::Group())
                 {
                     if (I::InputTextUTF8("Content Name", G::Config.ContentObjectNames, *Content.GetGUID(), Content.GetName() && Content.GetName()->Name && *Content.GetName()->Name ? *Content.GetName()->Name : Content.GetDisplayName()))
+                    {
+                        Data::Content::DisplayNameCache::NotifyCustomNameChanged();
                         G::Viewers::Notify(&ContentListViewer::ClearCache);
+                    }
                     I::InputTextUTF8("Namespace Name", G::Config.ContentNamespaceNames, Content.Namespace->GetFullName(), Content.Namespace->Name);
                     I::InputTextWithHint("Type Name", Utils::Encoding::ToUTF8(Content.Type->GetDisplayName()).c_str(), &typeInfo.Name);
                     I::AlignTextToFramePadding();
@@ -259,7 +262,7 @@ void ContentViewer::Draw()
                     .ShowVerticalScroll = context.Draw != DrawType::TableRow,
                     .OutHighlightOffset = highlightOffset,
                     .OutHighlightPointer = highlightPointer,
-                    .ByteMap = context.Content ? context.Content->ByteMap : nullptr,
+                    .ByteMap = context.Content ? [content = context.Content](uint32 offset) { return (byte)content->ByteMap->Get(content->ContentFileEntryOffset + offset); } : std::function<byte(uint32)>(),
                 };
                 HexViewer(data.subspan(unmappedStart, i - unmappedStart), options);
                 if (auto const offset = options.OutHighlightOffset)
@@ -693,6 +696,7 @@ void ContentViewer::Draw()
                 //added.Parent = layoutStack.top().Layout->Parent;
                 if (added.Name.empty())
                     added.Name = placeholderName;
+                Data::Content::NotifyLayoutEdited();
                 //added.FinishLoading();
 
                 symbol.Name.clear();
@@ -703,16 +707,11 @@ void ContentViewer::Draw()
 
             if (I::SameLine(); I::Button("List All Used Values"))
             {
-                auto itr = layout.emplace(offset, symbol);
-                auto& added = itr->second;
-                //added.Parent = layoutStack.top().Layout->Parent;
-                if (added.Name.empty())
-                    added.Name = placeholderName;
-                //added.FinishLoading();
+                auto listed = symbol;
+                if (listed.Name.empty())
+                    listed.Name = placeholderName;
 
-                G::Windows::ListContentValues.Set(*Content.Type, added, layoutStack);
-
-                layout.erase(itr);
+                G::Windows::ListContentValues.Set(*Content.Type, listed, offset, layoutStack);
             }
 
             if (I::GetWindowPos().y + I::GetWindowSize().y > I::GetIO().DisplaySize.y)
@@ -740,14 +739,16 @@ void ContentViewer::Draw()
             symbol->DrawOptions(typeInfo, layoutStack, parentPath, false, symbolItr != layout.end() ? std::format("field{:X}", symbolItr->first) : "");
             bool close = I::Button("Close");
 
+            if (symbolItr != layout.end())
             if (I::SameLine(); I::Button("List All Used Values"))
-                G::Windows::ListContentValues.Set(*Content.Type, *symbol, layoutStack);
+                G::Windows::ListContentValues.Set(*Content.Type, *symbol, symbolItr->first, layoutStack);
 
             if (symbolItr != layout.end())
             if (scoped::WithColorVar(ImGuiCol_Text, 0xFF0000FF))
             if (I::SameLine(); I::Button(ICON_FA_XMARK " Undefine"))
             {
                 layout.erase(symbolItr);
+                Data::Content::NotifyLayoutEdited();
                 close = true;
             }
 
@@ -67,7 +67,7 @@ struct FileListViewer : ListViewer<FileListViewer, { ICON_FA_FILE " Files", "Fil
                 ComplexSort(data, invert, [](File const& file) { return G::ArchiveIndex[file.GetSourceKind()].GetFileMetadata(file.ID).DataToString(); });
                 break;
             case Manifest:
-                ComplexSort(data, invert, [](File const& file) { return std::vector { std::from_range, file.GetManifestAsset().ManifestNames }; });
+                ComplexSort(data, invert, [](File const& file) { return std::vector { std::from_range, file.GetManifestAsset().GetManifestNames() }; });
                 break;
             case Added:
                 ComplexSort(data, invert, [](File const& file) { return G::ArchiveIndex[file.GetSourceKind()].GetFileAddedTimestamp(file.ID).Build; });
@@ -97,7 +97,7 @@ struct FileListViewer : ListViewer<FileListViewer, { ICON_FA_FILE " Files", "Fil
                 ComplexSort(data, invert, [](File const& file) { return file.GetMftEntry().alloc.crc; });
                 break;
             case Refs:
-                ComplexSort(data, invert, [](File const& file) { return G::Game.ReferencedFiles.contains(file.ID) ? 1 : 0; });
+                ComplexSort(data, invert, [](File const& file) { return G::Game.IsReferencedFile(file.ID) ? 1 : 0; });
                 break;
             default: std::terminate();
         }
@@ -296,7 +296,7 @@ struct FileListViewer : ListViewer<FileListViewer, { ICON_FA_FILE " Files", "Fil
 
                         Controls::CopyButton("Type", magic_enum::enum_name(metadata.Type)); I::SameLine();
                         Controls::CopyButton("Metadata", metadata.DataToString()); I::SameLine();
-                        Controls::CopyButton("Manifest", std::wstring { std::from_range, asset.ManifestNames | std::views::transform([](wchar_t const* manifestName) -> std::wstring_view { return manifestName; }) | std::views::join_with(L", "sv) }); I::SameLine();
+                        Controls::CopyButton("Manifest", std::wstring { std::from_range, asset.GetManifestNames() | std::views::join_with(L", "sv) }); I::SameLine();
                         Controls::CopyButton("FourCC", metadata.FourCCToString());
 
                         Controls::CopyButton("Added Build", addedTimestamp.Build); I::SameLine();
@@ -365,11 +365,11 @@ struct FileListViewer : ListViewer<FileListViewer, { ICON_FA_FILE " Files", "Fil
                     I::TableNextColumn();
                     if (!asset.ManifestNames.empty())
                     {
-                        I::Text(asset.ManifestNames.size() == 1 ? "%s" : "%s +%u", Utils::Encoding::ToUTF8(*asset.ManifestNames.begin()).c_str(), (uint32)(asset.ManifestNames.size() - 1));
+                        I::Text(asset.ManifestNames.size() == 1 ? "%s" : "%s +%u", Utils::Encoding::ToUTF8(*asset.GetManifestNames().begin()).c_str(), (uint32)(asset.ManifestNames.size() - 1));
                         if (scoped::ItemTooltip(asset.ManifestNames.size() > 1 ? ImGuiHoveredFlags_DelayNone : ImGuiHoveredFlags_None))
                         {
                             I::TextUnformatted(asset.ManifestNames.size() > 1 ? "<c=#4>Included in manifests:</c>" : "<c=#4>Included in manifest:</c>");
-                            for (auto const& manifestName : asset.ManifestNames)
+                            for (auto const manifestName : asset.GetManifestNames())
                                 I::TextUnformatted(Utils::Encoding::ToUTF8(manifestName).c_str());
                         }
                     }
@@ -414,7 +414,7 @@ struct FileListViewer : ListViewer<FileListViewer, { ICON_FA_FILE " Files", "Fil
                     I::TableNextColumn(); I::Text(entry.alloc.stream ? "%u" : "<c=#4>%u</c>", entry.alloc.stream);
                     I::TableNextColumn(); I::Text(entry.alloc.nextStream ? "%u" : "<c=#4>%u</c>", entry.alloc.nextStream);
                     I::TableNextColumn(); I::Text("%08X", entry.alloc.crc);
-                    I::TableNextColumn(); if (G::Game.ReferencedFiles.contains(file.ID)) I::TextColored({ 0, 0.5f, 1, 1 }, ICON_FA_ARROW_LEFT "EXE");
+                    I::TableNextColumn(); if (G::Game.IsReferencedFile(file.ID)) I::TextColored({ 0, 0.5f, 1, 1 }, ICON_FA_ARROW_LEFT "EXE");
                 }
             }
         }
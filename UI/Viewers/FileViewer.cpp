@@ -41,6 +41,7 @@ void FileViewer::Draw()
     bool drawHex = false;
     bool drawOutline = false;
     bool drawPreview = false;
+    bool drawReferences = false;
     if (scoped::Child(I::GetSharedScopeID("FileViewer"), { }, ImGuiChildFlags_Borders | ImGuiChildFlags_FrameStyle | ImGuiChildFlags_AutoResizeY))
     {
         DrawHistoryButtons();
@@ -59,6 +60,9 @@ void FileViewer::Draw()
                 drawOutline = true;
             if (scoped::TabItem(ICON_FA_IMAGE " Preview", nullptr, ImGuiTabItemFlags_NoCloseButton | ImGuiTabItemFlags_NoCloseWithMiddleMouseButton))
                 drawPreview = true;
+            if (G::Game.Content.IsLoaded())
+                if (scoped::TabItem(std::format(ICON_FA_ARROW_LEFT " Referenced By ({})###ReferencedBy", std::ranges::distance(G::Game.Content.GetFileReferences(File.ID))).c_str(), nullptr, ImGuiTabItemFlags_NoCloseButton | ImGuiTabItemFlags_NoCloseWithMiddleMouseButton))
+                    drawReferences = true;
         }
     }
 
@@ -68,6 +72,11 @@ void FileViewer::Draw()
             DrawOutline();
     if (drawPreview)
         DrawPreview();
+    if (drawReferences)
+        if (scoped::Child("References"))
+        if (scoped::WithStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2()))
+        for (auto const object : G::Game.Content.GetFileReferences(File.ID))
+            Controls::ContentButton(object, object, { .Icon = ICON_FA_ARROW_LEFT });
 
     if (!drawHex)
         return;
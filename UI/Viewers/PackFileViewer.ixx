@@ -8,6 +8,7 @@ import GW2Viewer.Data.Pack;
 import GW2Viewer.Data.Pack.PackFile;
 import GW2Viewer.UI.Controls;
 import GW2Viewer.UI.ImGui;
+import GW2Viewer.UI.Notifications;
 import GW2Viewer.UI.Viewers.FileViewer;
 import GW2Viewer.Utils.Encoding;
 import std;
@@ -654,13 +655,33 @@ struct PackFileViewer : FileViewer
         {
             std::string const fcc { (char const*)&chunk.Header.Magic, 4 };
             auto const* p = chunk.Data;
+            Data::Pack::Layout::Type const* layout = nullptr;
+            if (auto const chunkVersions = G::Game.Pack.GetChunk(fcc))
+                if (auto const itrChunkVersion = chunkVersions->find(chunk.Header.Version); itrChunkVersion != chunkVersions->end())
+                    layout = itrChunkVersion->second;
             I::TextUnformatted(std::format("Chunk <{}>", fcc.c_str()).c_str());
+            if (layout)
+            {
+                I::SameLine();
+                if (I::SmallButton(std::format(ICON_FA_CODE "##GenerateStruct-{}", (void const*)&chunk).c_str()))
+                {
+                    try
+                    {
+                        I::SetClipboardText(Data::Pack::Layout::Generated::Generate(fcc, chunk.Header.Version, PackFile->Header.Is64Bit).c_str());
+                    }
+                    catch (std::exception const& ex)
+                    {
+                        G::Notifications.AddCloseable({ .Text = std::format("Failed to generate structs for chunk <{}> v{}:\n{}", fcc.c_str(), chunk.Header.Version, ex.what()) });
+                    }
+                }
+                if (I::IsItemHovered())
+                    I::SetTooltip("Copy chunk layout as C++ structs");
+            }
             I::Dummy({ 25, 0 });
             I::SameLine();
             if (scoped::Group())
-                if (auto const chunkVersions = G::Game.Pack.GetChunk(fcc))
-                    if (auto const itrChunkVersion = chunkVersions->find(chunk.Header.Version); itrChunkVersion != chunkVersions->end())
-                        DrawPackFileType(p, PackFile->Header.Is64Bit, itrChunkVersion->second);
+                if (layout)
+                    DrawPackFileType(p, PackFile->Header.Is64Bit, layout);
         }
     }
     void DrawPreview() override
@@ -1,6 +1,7 @@
 export module GW2Viewer.UI.Viewers.StringListViewer;
 import GW2Viewer.Common;
 import GW2Viewer.Common.Time;
+import GW2Viewer.Data.Content;
 import GW2Viewer.Data.Encryption;
 import GW2Viewer.Data.Game;
 import GW2Viewer.UI.Controls;
@@ -292,6 +293,16 @@ struct StringListViewer : ListViewer<StringListViewer, { ICON_FA_TEXT " Strings"
 
                         if (I::Button("Search for Content References"))
                             G::Windows::ContentSearch.SearchForSymbolValue("StringID", stringID);
+
+                        if (auto const references = G::Game.Content.FindBySymbolValue(*Data::Content::Symbols::GetByName("StringID"), stringID); references && !references->empty())
+                        {
+                            I::Text("Referenced by %zu objects:", references->size());
+                            I::SetNextWindowSizeConstraints({ }, { FLT_MAX, 300 });
+                            if (scoped::Child("References", { }, ImGuiChildFlags_AutoResizeY))
+                            if (scoped::WithStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2()))
+                            for (auto const object : *references)
+                                Controls::ContentButton(object, object, { .Icon = ICON_FA_ARROW_LEFT });
+                        }
                     }
 
                     I::TableNextColumn();
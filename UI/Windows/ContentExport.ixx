@@ -24,6 +24,7 @@ struct ContentExport : Window
     Data::Content::ExportOptions Options;
     int Indent = 2;
     int IndentChar = ' ';
+    bool NDJSON = false;
     std::optional<std::filesystem::path> Path;
     std::string Preview;
 
@@ -40,17 +41,22 @@ struct ContentExport : Window
 
     void Draw() override
     {
-        I::AlignTextToFramePadding(); I::Text("Indentation:"); I::SameLine();
-        I::SetNextItemWidth(60);
-        I::DragInt("##Indent", &Indent, 0.05f, -1, 8, Indent >= 0 ? "%d" : "compact");
-        if (I::IsItemHovered())
-            I::SetMouseCursor(ImGuiMouseCursor_ResizeEW);
-        if (Indent > 0)
+        I::Checkbox("One compact object per line (NDJSON)", &NDJSON);
+
+        if (scoped::Disabled(NDJSON))
         {
-            I::SameLine();
-            I::RadioButton(std::format("space{}##IndentSpace", Indent != 1 ? "s" : "").c_str(), &IndentChar, ' ');
-            I::SameLine();
-            I::RadioButton(std::format("tab{}##IndentSpace", Indent != 1 ? "s" : "").c_str(), &IndentChar, '\t');
+            I::AlignTextToFramePadding(); I::Text("Indentation:"); I::SameLine();
+            I::SetNextItemWidth(60);
+            I::DragInt("##Indent", &Indent, 0.05f, -1, 8, Indent >= 0 ? "%d" : "compact");
+            if (I::IsItemHovered())
+                I::SetMouseCursor(ImGuiMouseCursor_ResizeEW);
+            if (Indent > 0)
+            {
+                I::SameLine();
+                I::RadioButton(std::format("space{}##IndentSpace", Indent != 1 ? "s" : "").c_str(), &IndentChar, ' ');
+                I::SameLine();
+                I::RadioButton(std::format("tab{}##IndentSpace", Indent != 1 ? "s" : "").c_str(), &IndentChar, '\t');
+            }
         }
 
         I::Checkbox("Ignore unnamed fields", &Options.IgnoreUnnamedFields);
@@ -90,27 +96,32 @@ struct ContentExport : Window
         if (scoped::Disabled(Async.Current()))
         if (I::Button(std::format("Export {} Object{}", Objects.size(), Objects.size() != 1 ? "s" : "").c_str()))
         {
-            Async.Run([this, Objects = Objects, Options = Options, Indent = Indent, IndentChar = IndentChar](Utils::Async::Context context)
+            Async.Run([this, Objects = Objects, Options = Options, StreamOptions = Data::Content::ExportStreamOptions { Indent, (char)IndentChar, NDJSON }](Utils::Async::Context context)
             {
                 context->SetTotal(Objects.size());
-                ordered_json result;
-                for (auto const object : Objects)
-                {
-                    CHECK_ASYNC;
-                    if (auto json = Data::Content::ExportSymbolData(*object, Options); !json.empty())
-                        result.emplace_back(std::move(json));
-                    context->Increment();
-                }
-
-                CHECK_ASYNC;
-                context->SetIndeterminate();
-                std::filesystem::path path = std::format(R"(Export\Game Content\json\{}\{:%F_%H-%M-%S}Z.json)", G::Game.Build, Time::Now());
+                std::filesystem::path path = std::format(R"(Export\Game Content\json\{}\{:%F_%H-%M-%S}Z.{})", G::Game.Build, Time::Now(), StreamOptions.NDJSON ? "ndjson" : "json");
                 create_directories(path.parent_path());
                 auto originalPath = path;
                 int attempt = 1;
                 while (exists(path))
                     path.replace_filename(originalPath.stem().string() + std::format(" ({})", attempt++) + originalPath.extension().string());
-                std::ofstream(path) << std::setw(Indent) << std::setfill((char)IndentChar) << result << std::endl;
+
+                bool const completed = [&]
+                {
+                    std::ofstream file(path);
+                    return Data::Content::ExportSymbolData(Objects, file, Options, StreamOptions, [&context](size_t processed)
+                    {
+                        if (!context || context->Cancelled)
+                            return false;
+                        context->Current = (uint32)processed;
+                        return true;
+                    });
+                }();
+                if (!completed)
+                {
+                    std::filesystem::remove(path); // Don't leave a partial export behind
+                    return;
+                }
 
                 std::scoped_lock _(Lock);
                 Path = path;
@@ -131,7 +142,7 @@ struct ContentExport : Window
             I::SameLine();
             I::SetNextItemWidth(-FLT_MIN);
             if (scoped::Disabled(true))
-                I::InputTextReadOnly("##Description", context.IsIndeterminate() ? "Writing file..." : std::format("{} / {}", context.Current, context.Total));
+                I::InputTextReadOnly("##Description", std::format("{} / {}", context.Current, context.Total));
             Controls::AsyncProgressBar(Async);
         }
         else if (Path)
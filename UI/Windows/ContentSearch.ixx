@@ -32,6 +32,15 @@ struct ContentSearch : Window
                 Value = value;
                 Results.clear();
             }
+            if (auto results = G::Game.Content.FindBySymbolValue(*Symbol, Value))
+            {
+                std::scoped_lock _(Lock);
+                Results = *std::move(results);
+                context->Finish();
+                return;
+            }
+            G::Game.Content.UpdateSymbolValueIndex();
+
             auto _ = Utils::Exception::SEHandler::Create();
             context->SetTotal(G::Game.Content.GetObjects().size());
             std::for_each(std::execution::par_unseq, G::Game.Content.GetObjects().begin(), G::Game.Content.GetObjects().end(), [this, context, processed = 0](Data::Content::ContentObject const* content) mutable
@@ -435,7 +435,10 @@ struct Demangle : Window
 
                     I::TableNextColumn();
                     if (I::Button("<c=#0F0>" ICON_FA_CHECK "</c>") || apply)
+                    {
                         G::Config.ContentObjectNames[*object->GetGUID()] = name;
+                        Data::Content::DisplayNameCache::NotifyCustomNameChanged();
+                    }
                     I::SameLine(0, 0);
                     if (I::Button("<c=#F00>" ICON_FA_XMARK "</c>"))
                         eraseObject.emplace(object, name);
@@ -4,7 +4,8 @@ import GW2Viewer.Data.Content;
 import GW2Viewer.UI.Controls;
 import GW2Viewer.UI.ImGui;
 import GW2Viewer.UI.Windows.Window;
-import GW2Viewer.Utils.Sort;
+import GW2Viewer.Utils.Async;
+import GW2Viewer.Utils.Exception;
 import std;
 #include "Macros.h"
 
@@ -29,23 +30,39 @@ struct ListContentValues : Window
     {
         Data::Content::TypeInfo::Symbol Symbol;
         byte const* Data;
-        std::unordered_set<Data::Content::ContentObject const*> Objects;
-        std::vector<Data::Content::ContentObject const*> ObjectsSorted;
+        std::vector<Data::Content::ContentObject const*> ObjectsSorted; // In the order they were found until the refresh completes
         bool IsFolded = true;
     };
+    using ResultMap = std::map<CachedKey, CachedValue>;
+    // Keys of values split into flags point in here, so that they stay valid without being stored per refresh
+    static constexpr auto FlagKeyStorage = []
+    {
+        std::array<Data::Content::TypeInfo::Condition::ValueType, sizeof(Data::Content::TypeInfo::Condition::ValueType) * 8> flags { };
+        for (auto const& [bit, flag] : flags | std::views::enumerate)
+            flag = (Data::Content::TypeInfo::Condition::ValueType)1 << bit;
+        return flags;
+    }();
+
+    Utils::Async::Scheduler Async;
+    std::mutex Lock;
 
     Data::Content::ContentTypeInfo const* Type = nullptr;
+    std::string ParentPath;
     std::string SymbolPath;
+    Data::Content::TypeInfo::Symbol Symbol; // Copied, the symbol might only be part of the layout while it's being listed
+    uint32 SymbolOffset = 0;
     bool IsEnum = false;
     bool IncludeZero = false;
     bool AsFlags = false;
-    std::map<CachedKey, CachedValue> Results;
-    std::set<Data::Content::TypeInfo::Condition::ValueType> ExternalKeyStorage;
+    ResultMap Results;
 
-    void Set(Data::Content::ContentTypeInfo const& type, Data::Content::TypeInfo::Symbol const& symbol, Data::Content::TypeInfo::LayoutStack const& layoutStack)
+    void Set(Data::Content::ContentTypeInfo const& type, Data::Content::TypeInfo::Symbol const& symbol, uint32 offset, Data::Content::TypeInfo::LayoutStack const& layoutStack)
     {
         Type = &type;
-        SymbolPath = symbol.GetFullPath(*layoutStack.top().Path);
+        ParentPath = *layoutStack.top().Path;
+        SymbolPath = symbol.GetFullPath(ParentPath);
+        Symbol = symbol;
+        SymbolOffset = offset;
         IsEnum = symbol.GetEnum();
         IncludeZero = IsEnum && !symbol.GetEnum()->Flags;
         AsFlags = IsEnum && symbol.GetEnum()->Flags;
@@ -54,40 +71,110 @@ struct ListContentValues : Window
     }
     void Refresh()
     {
-        Results.clear();
-        ExternalKeyStorage.clear();
-        for (Data::Content::SymbolPath const path { SymbolPath }; auto const object : Type->Objects)
+        Async.Run([this, type = Type, path = ParentPath, symbol = Symbol, offset = SymbolOffset, includeZero = IncludeZero, asFlags = AsFlags](Utils::Async::Context context) mutable
         {
-            for (auto& result : Data::Content::QuerySymbolData(*object, path))
             {
-                if (CachedKey key { { &result.Data<byte>(), result.Symbol.Size() }, result.Symbol.GetType() }; IncludeZero || std::ranges::any_of(key.Data, std::identity())) // Only show non-zero values
+                std::scoped_lock _(Lock);
+                Results.clear();
+            }
+            if (!type)
+            {
+                context->Finish();
+                return;
+            }
+
+            // Each chunk aggregates into its own map, which is merged into the shared results as soon as it's done to show partial results
+            auto _ = Utils::Exception::SEHandler::Create();
+            auto const& query = Data::Content::CompileSymbolPath(path);
+            auto const objects = std::span(type->Objects);
+            static constexpr size_t ChunkSize = 256;
+            std::vector<ResultMap> chunks((objects.size() + ChunkSize - 1) / ChunkSize);
+            context->SetTotal(objects.size());
+            std::for_each(std::execution::par, chunks.begin(), chunks.end(), [&](ResultMap& chunk)
+            {
+                CHECK_SHARED_ASYNC;
+                auto const begin = std::distance(chunks.data(), &chunk) * ChunkSize;
+                auto const chunkObjects = objects.subspan(begin, std::min(ChunkSize, objects.size() - begin));
+                for (auto const object : chunkObjects)
                 {
-                    if (auto const e = result.Symbol.GetEnum(); e && e->Flags && AsFlags)
+                    auto add = [&chunk, object](CachedKey const& key, Data::Content::TypeInfo::Symbol const& symbol, byte const* data)
+                    {
+                        // An object's results are found one after another, so repeated values only need to be checked against the last object
+                        if (auto& objects = chunk.try_emplace(key, symbol, data).first->second.ObjectsSorted; objects.empty() || objects.back() != object)
+                            objects.emplace_back(object);
+                    };
+                    try
                     {
-                        if (auto value = key.Type->GetValueForCondition({ &result.Data<byte>(), *object, result.Symbol }).value_or(0))
+                        object->Finalize();
+                        query.ForEach(*object, symbol, offset, [&](Data::Content::QuerySymbolDataResult const& result)
                         {
-                            for (decltype(value) flag = 1; flag; flag <<= 1)
+                            if (CachedKey key { { &result.Data<byte>(), result.Symbol.Size() }, result.Symbol.GetType() }; includeZero || std::ranges::any_of(key.Data, std::identity())) // Only show non-zero values
                             {
-                                if (value & flag)
+                                if (auto const e = result.Symbol.GetEnum(); e && e->Flags && asFlags)
                                 {
-                                    auto data = (byte const*)&*ExternalKeyStorage.emplace(flag).first;
-                                    Results.try_emplace({ { data, sizeof(decltype(ExternalKeyStorage)::value_type) } }, result.Symbol, data).first->second.Objects.emplace(object);
+                                    if (auto value = key.Type->GetValueForCondition({ &result.Data<byte>(), *object, result.Symbol }).value_or(0))
+                                    {
+                                        for (auto const& flag : FlagKeyStorage)
+                                            if (value & flag)
+                                                add({ { (byte const*)&flag, sizeof(flag) } }, result.Symbol, (byte const*)&flag);
+                                        return true;
+                                    }
                                 }
+                                add(key, result.Symbol, &result.Data<byte>());
                             }
-                            continue;
-                        }
+                            return true;
+                        });
                     }
-                    Results.try_emplace(key, result.Symbol, &result.Data<byte>()).first->second.Objects.emplace(object);
+                    catch (...) { }
+                }
+
+                {
+                    std::scoped_lock _(Lock);
+                    for (auto& [key, value] : chunk)
+                        Results.try_emplace(key, value.Symbol, value.Data).first->second.ObjectsSorted.append_range(value.ObjectsSorted);
                 }
+                chunk.clear();
+                context->InterlockedIncrement(chunkObjects.size());
+            });
+            CHECK_SHARED_ASYNC;
+
+            // Every object of every value is sorted at once, building the sort keys is the expensive part so it's also done in parallel
+            std::vector<CachedValue*> values;
+            {
+                std::scoped_lock _(Lock);
+                values = Results | std::views::values | std::views::transform([](CachedValue& value) { return &value; }) | std::ranges::to<std::vector>();
             }
-        }
-        for (auto& value : Results | std::views::values)
-            value.ObjectsSorted = Utils::Sort::ComplexSorted(value.Objects, false, [](Data::Content::ContentObject const* object) { return std::make_tuple(object->GetFullDisplayName(), object->GetFullName(), object->Type->Index, object->Index); });
+            using SortKey = std::tuple<std::wstring, std::wstring, uint32, uint32>;
+            std::vector<std::tuple<uint32, SortKey, Data::Content::ContentObject const*>> sortable;
+            for (auto const& [index, value] : values | std::views::enumerate)
+                for (auto const object : value->ObjectsSorted)
+                    sortable.emplace_back((uint32)index, SortKey(), object);
+            context->SetIndeterminate();
+            std::for_each(std::execution::par, sortable.begin(), sortable.end(), [](auto& entry)
+            {
+                auto& [index, key, object] = entry;
+                key = { object->GetFullDisplayName(), object->GetFullName(), object->Type->Index, object->Index };
+            });
+            CHECK_SHARED_ASYNC;
+            std::sort(std::execution::par, sortable.begin(), sortable.end());
+
+            std::vector<std::vector<Data::Content::ContentObject const*>> sorted(values.size());
+            for (auto const& [index, key, object] : sortable)
+                sorted[index].emplace_back(object);
+            {
+                std::scoped_lock _(Lock);
+                for (auto const& [value, objects] : std::views::zip(values, sorted))
+                    value->ObjectsSorted = std::move(objects);
+            }
+            context->Finish();
+        });
     }
 
     std::string Title() override { return "List Content Values"; }
     void Draw() override
     {
+        std::unique_lock lock(Lock);
+        bool refresh = false;
         if (scoped::WithStyleVar(ImGuiStyleVar_CellPadding, ImVec2()))
         if (scoped::Table("Header", 3, ImGuiTableFlags_NoSavedSettings, { -FLT_MIN, 0 }))
         {
@@ -97,11 +184,12 @@ struct ListContentValues : Window
 
             I::TableNextColumn();
             if (I::Button(ICON_FA_ARROWS_ROTATE " Refresh"))
-                Refresh();
+                refresh = true;
+            Controls::AsyncProgressBar(Async);
             if (I::SameLine(), I::Checkbox("Include Zero", &IncludeZero))
-                Refresh();
+                refresh = true;
             if (IsEnum && (I::SameLine(), I::Checkbox("As Flags", &AsFlags)))
-                Refresh();
+                refresh = true;
 
             I::TableNextColumn();
 
@@ -174,6 +262,11 @@ struct ListContentValues : Window
                 }
             }
         }
+
+        // Starting a refresh waits for the previous one to stop, which might be waiting for the lock
+        lock.unlock();
+        if (refresh)
+            Refresh();
     }
 };
 
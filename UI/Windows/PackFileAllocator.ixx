@@ -0,0 +1,74 @@
+export module GW2Viewer.UI.Windows.PackFileAllocator;
+import GW2Viewer.Common;
+import GW2Viewer.Data.Pack.PackFile;
+import GW2Viewer.UI.ImGui;
+import GW2Viewer.UI.Windows.Window;
+import std;
+#include "Macros.h"
+
+export namespace GW2Viewer::UI::Windows
+{
+
+struct PackFileAllocator : Window
+{
+    bool ShowUnused = false;
+
+    std::string Title() override { return "PackFile Allocator"; }
+    void Draw() override
+    {
+        auto& allocator = Data::Pack::GetPackFileAllocator();
+        auto const stats = allocator.GetStats();
+        auto formatSize = [](size_t bytes)
+        {
+            if (bytes >= 1 << 20)
+                return std::format("{:.1f} MB", bytes / (float)(1 << 20));
+            if (bytes >= 1 << 10)
+                return std::format("{:.1f} KB", bytes / (float)(1 << 10));
+            return std::format("{} B", bytes);
+        };
+
+        I::Text("Reserved: %s", formatSize(stats.ReservedBytes).c_str());
+        I::SameLine();
+        I::Text("<c=#8>Cached: %s</c>", formatSize(stats.CachedBytes).c_str());
+        I::SameLine();
+        if (I::Button("Trim"))
+            allocator.Trim();
+        I::SameLine();
+        I::Checkbox("Show Unused Size Classes", &ShowUnused);
+
+        if (scoped::Table("SizeClasses", 7, ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY | ImGuiTableFlags_NoSavedSettings, { -FLT_MIN, -FLT_MIN }))
+        {
+            I::TableSetupScrollFreeze(0, 1);
+            I::TableSetupColumn("Block Size");
+            I::TableSetupColumn("Requests");
+            I::TableSetupColumn("Reused");
+            I::TableSetupColumn("Live Blocks");
+            I::TableSetupColumn("Live Bytes");
+            I::TableSetupColumn("Cached Blocks");
+            I::TableSetupColumn("Slabs");
+            I::TableHeadersRow();
+
+            auto drawRow = [&](std::string const& blockSize, Data::Pack::PackFileAllocator::SizeClassStats const& sizeClass)
+            {
+                if (!ShowUnused && !sizeClass.Requests)
+                    return;
+
+                I::TableNextRow();
+                I::TableNextColumn(); I::TextUnformatted(blockSize.c_str());
+                I::TableNextColumn(); I::Text("%zu", sizeClass.Requests);
+                I::TableNextColumn(); I::Text("%zu", sizeClass.Reused);
+                I::TableNextColumn(); I::Text("%zu", sizeClass.LiveBlocks);
+                I::TableNextColumn(); I::TextUnformatted(formatSize(sizeClass.LiveBytes).c_str());
+                I::TableNextColumn(); I::Text("%zu", sizeClass.CachedBlocks);
+                I::TableNextColumn(); I::Text("%zu", sizeClass.Slabs);
+            };
+            for (auto const& sizeClass : stats.Classes)
+                drawRow(formatSize(sizeClass.BlockSize), sizeClass);
+            drawRow(std::format("> {}", formatSize(stats.Direct.BlockSize)), stats.Direct);
+        }
+    }
+};
+
+}
+
+export namespace GW2Viewer::G::Windows { UI::Windows::PackFileAllocator PackFileAllocator; }
@@ -92,6 +92,7 @@ struct Config
     std::map<std::string, Data::Content::TypeInfo::Enum> SharedEnums;
     std::map<std::wstring, std::wstring> ContentNamespaceNames;
     std::map<GUID, std::wstring> ContentObjectNames;
+    std::map<uint32, uint64> ContentFileKeys;
     uint32 LastNumContentTypes = 0;
 
     NLOHMANN_DEFINE_TYPE_ORDERED_INTRUSIVE_WITH_DEFAULT(Config
@@ -118,6 +119,7 @@ struct Config
         , SharedEnums
         , ContentNamespaceNames
         , ContentObjectNames
+        , ContentFileKeys
         , LastNumContentTypes
     )
     void FinishLoading()
@@ -71,6 +71,143 @@ auto Find(Container&& container, T&& value)
     return itr != container.end() ? &*itr : nullptr;
 }
 
+// Binary searches over sorted contiguous ranges without data dependent branches, the selection compiles to a conditional move
+template<std::ranges::contiguous_range Range, typename T>
+[[nodiscard]] auto BranchlessLowerBound(Range const& range, T const& value)
+{
+    auto base = std::ranges::data(range);
+    auto size = std::ranges::size(range);
+    if (!size)
+        return base;
+    while (size > 1)
+    {
+        auto const half = size / 2;
+        base = base[half] < value ? base + half : base;
+        size -= half;
+    }
+    return base + (*base < value);
+}
+template<std::ranges::contiguous_range Range, typename T>
+[[nodiscard]] auto BranchlessUpperBound(Range const& range, T const& value)
+{
+    auto base = std::ranges::data(range);
+    auto size = std::ranges::size(range);
+    if (!size)
+        return base;
+    while (size > 1)
+    {
+        auto const half = size / 2;
+        base = !(value < base[half]) ? base + half : base;
+        size -= half;
+    }
+    return base + !(value < *base);
+}
+template<std::ranges::contiguous_range Range, typename T>
+[[nodiscard]] bool BranchlessContains(Range const& range, T const& value)
+{
+    auto const itr = BranchlessLowerBound(range, value);
+    return itr != std::ranges::data(range) + std::ranges::size(range) && !(value < *itr);
+}
+
+template<typename Container>
+void SortAndDeduplicate(Container& container)
+{
+    std::ranges::sort(container);
+    container.erase(std::ranges::unique(container).begin(), container.end());
+}
+
+// Linear probing hash map over a power of two slot array. Entries are stored densely in insertion order and slots only hold their
+// index + 1, so a lookup touches one slot run and one entry, and iterating is a plain array walk. Entries can't be erased.
+template<typename Key, typename Value, typename Hash = std::hash<Key>>
+class OpenAddressingMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using iterator = typename std::vector<value_type>::iterator;
+    using const_iterator = typename std::vector<value_type>::const_iterator;
+
+    [[nodiscard]] std::size_t size() const { return m_entries.size(); }
+    [[nodiscard]] bool empty() const { return m_entries.empty(); }
+    [[nodiscard]] iterator begin() { return m_entries.begin(); }
+    [[nodiscard]] iterator end() { return m_entries.end(); }
+    [[nodiscard]] const_iterator begin() const { return m_entries.begin(); }
+    [[nodiscard]] const_iterator end() const { return m_entries.end(); }
+    [[nodiscard]] std::size_t GetMemoryUsage() const { return m_entries.capacity() * sizeof(value_type) + m_slots.capacity() * sizeof(std::uint32_t); }
+
+    void clear()
+    {
+        m_entries.clear();
+        std::ranges::fill(m_slots, 0);
+    }
+    void reserve(std::size_t count)
+    {
+        m_entries.reserve(count);
+        if (count * 2 > m_slots.size())
+            Rehash(std::bit_ceil(std::max<std::size_t>(count * 2, 16)));
+    }
+
+    [[nodiscard]] iterator find(Key const& key) { auto const slot = FindSlot(key); return slot && m_slots[*slot] ? m_entries.begin() + (m_slots[*slot] - 1) : m_entries.end(); }
+    [[nodiscard]] const_iterator find(Key const& key) const { auto const slot = FindSlot(key); return slot && m_slots[*slot] ? m_entries.begin() + (m_slots[*slot] - 1) : m_entries.end(); }
+    [[nodiscard]] bool contains(Key const& key) const { return find(key) != end(); }
+
+    std::pair<iterator, bool> emplace(Key const& key, Value value)
+    {
+        if ((m_entries.size() + 1) * 2 > m_slots.size())
+            Rehash(std::max<std::size_t>(m_slots.size() * 2, 16));
+
+        auto const slot = *FindSlot(key);
+        if (m_slots[slot])
+            return { m_entries.begin() + (m_slots[slot] - 1), false };
+
+        m_entries.emplace_back(key, std::move(value));
+        m_slots[slot] = (std::uint32_t)m_entries.size();
+        return { std::prev(m_entries.end()), true };
+    }
+    Value& operator[](Key const& key) { return emplace(key, Value()).first->second; }
+
+private:
+    std::vector<value_type> m_entries;
+    std::vector<std::uint32_t> m_slots;
+    std::uint32_t m_shift = 64;
+
+    // Fibonacci hashing takes the slot from the high bits, so keys that only differ in their low bits, like sequential IDs, still spread out
+    [[nodiscard]] std::size_t GetHomeSlot(Key const& key) const
+    {
+        std::uint64_t hash;
+        if constexpr (std::is_integral_v<Key>)
+            hash = (std::uint64_t)key;
+        else
+            hash = Hash()(key);
+        return (hash * 0x9E3779B97F4A7C15ull) >> m_shift;
+    }
+    // Returns the slot holding the key, or the empty slot where it would be inserted
+    [[nodiscard]] std::optional<std::size_t> FindSlot(Key const& key) const
+    {
+        if (m_slots.empty())
+            return { };
+
+        auto const mask = m_slots.size() - 1;
+        for (auto slot = GetHomeSlot(key); ; slot = (slot + 1) & mask)
+            if (!m_slots[slot] || m_entries[m_slots[slot] - 1].first == key)
+                return slot;
+    }
+    void Rehash(std::size_t slots)
+    {
+        m_slots.assign(slots, 0);
+        m_shift = 64 - std::countr_zero(slots);
+        auto const mask = slots - 1;
+        for (auto const& [index, entry] : m_entries | std::views::enumerate)
+        {
+            auto slot = GetHomeSlot(entry.first);
+            while (m_slots[slot])
+                slot = (slot + 1) & mask;
+            m_slots[slot] = (std::uint32_t)index + 1;
+        }
+    }
+};
+
 template<typename Set, typename T>
 bool TogglePresence(Set& set, T const& element, bool present)
 {
@@ -0,0 +1,103 @@
+export module GW2Viewer.Utils.Intern;
+import GW2Viewer.Common;
+import std;
+
+export namespace GW2Viewer::Utils::Intern
+{
+
+// Append-only set of unique strings that can be used from any thread. Every string is copied once into shared pages and identified by
+// a 32-bit ID, so equal strings compare by ID, and the views returned for an ID stay valid for the rest of the session. ID 0 is the empty string.
+template<typename Char>
+class InternTable
+{
+public:
+    using View = std::basic_string_view<Char>;
+
+    InternTable()
+    {
+        m_views.emplace_back();
+        m_ids.emplace(View(), 0);
+    }
+    InternTable(InternTable const&) = delete;
+    InternTable& operator=(InternTable const&) = delete;
+
+    [[nodiscard]] uint32 Intern(View string)
+    {
+        if (auto const id = Find(string))
+            return *id;
+
+        std::unique_lock _(m_lock);
+        if (auto const itr = m_ids.find(string); itr != m_ids.end())
+            return itr->second;
+
+        auto const stored = Store(string);
+        auto const id = (uint32)m_views.size();
+        m_views.emplace_back(stored);
+        m_ids.emplace(stored, id);
+        return id;
+    }
+    [[nodiscard]] std::optional<uint32> Find(View string) const
+    {
+        std::shared_lock _(m_lock);
+        if (auto const itr = m_ids.find(string); itr != m_ids.end())
+            return itr->second;
+        return { };
+    }
+    [[nodiscard]] View Get(uint32 id) const
+    {
+        std::shared_lock _(m_lock);
+        return m_views.at(id);
+    }
+
+    [[nodiscard]] size_t size() const { std::shared_lock _(m_lock); return m_views.size(); }
+    [[nodiscard]] size_t GetMemoryUsage() const
+    {
+        std::shared_lock _(m_lock);
+        return m_storedSize * sizeof(Char) + m_views.size() * sizeof(View) + m_ids.size() * (2 * sizeof(void*) + sizeof(std::pair<View, uint32>)) + m_ids.bucket_count() * 2 * sizeof(void*);
+    }
+
+private:
+    static constexpr size_t PageSize = 64 * 1024;
+
+    mutable std::shared_mutex m_lock;
+    std::vector<std::unique_ptr<Char[]>> m_pages; // The current page is always the last one
+    size_t m_pageUsed = PageSize;
+    size_t m_storedSize = 0;
+    std::deque<View> m_views;
+    std::unordered_map<View, uint32> m_ids;
+
+    [[nodiscard]] View Store(View string)
+    {
+        Char* data;
+        if (string.size() > PageSize / 16)
+        {
+            // Long strings get a page of their own, so they don't leave most of the current page unused
+            data = m_pages.emplace(m_pages.empty() ? m_pages.end() : std::prev(m_pages.end()), std::make_unique_for_overwrite<Char[]>(string.size()))->get();
+            m_storedSize += string.size();
+        }
+        else
+        {
+            if (m_pageUsed + string.size() > PageSize)
+            {
+                m_pages.emplace_back(std::make_unique_for_overwrite<Char[]>(PageSize));
+                m_pageUsed = 0;
+                m_storedSize += PageSize;
+            }
+            data = &m_pages.back()[m_pageUsed];
+            m_pageUsed += string.size();
+        }
+        std::ranges::copy(string, data);
+        return { data, string.size() };
+    }
+};
+
+template<typename Char>
+[[nodiscard]] InternTable<Char>& GetTable()
+{
+    static InternTable<Char> instance;
+    return instance;
+}
+[[nodiscard]] uint32 Intern(std::string_view string) { return GetTable<char>().Intern(string); }
+[[nodiscard]] uint32 Intern(std::wstring_view string) { return GetTable<wchar_t>().Intern(string); }
+
+}
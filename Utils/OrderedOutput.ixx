@@ -0,0 +1,61 @@
+export module GW2Viewer.Utils.OrderedOutput;
+import GW2Viewer.Common;
+import GW2Viewer.Common.JSON;
+import std;
+
+export namespace GW2Viewer::Utils::OrderedOutput
+{
+
+// Writes the buffers in index order as soon as every buffer before them is complete
+class Writer
+{
+public:
+    Writer(std::ostream& output, size_t count) : m_output(output), m_buffers(count) { }
+
+    void Complete(size_t index, std::string&& buffer)
+    {
+        std::scoped_lock _(m_mutex);
+        m_buffers[index] = std::move(buffer);
+        for (; m_next < m_buffers.size() && m_buffers[m_next]; ++m_next)
+        {
+            m_output << *m_buffers[m_next];
+            m_buffers[m_next].emplace();
+        }
+    }
+
+private:
+    std::ostream& m_output;
+    std::vector<std::optional<std::string>> m_buffers;
+    size_t m_next = 0;
+    std::mutex m_mutex;
+};
+
+// Serializes the elements in parallel batches and passes their buffers to write in element order, so only one batch of serialized elements is held in memory at a time.
+// progress is called with the number of processed elements after every batch, returning false stops before the next one.
+template<typename T>
+bool ForEachBatch(std::span<T const> elements, std::invocable<T const&, std::string&> auto&& serialize, std::invocable<std::string const&> auto&& write, std::invocable<size_t> auto&& progress)
+{
+    static constexpr size_t BatchSize = 1024;
+    std::vector<std::string> buffers(std::min(BatchSize, elements.size()));
+    for (size_t begin = 0; begin < elements.size(); begin += BatchSize)
+    {
+        auto const batch = elements.subspan(begin, std::min(BatchSize, elements.size() - begin));
+        std::for_each(std::execution::par, batch.begin(), batch.end(), [&](T const& element)
+        {
+            auto& buffer = buffers[std::distance(batch.data(), &element)];
+            buffer.clear();
+            serialize(element, buffer);
+        });
+
+        for (auto const& buffer : buffers | std::views::take(batch.size()))
+            write(buffer);
+        if (!progress(begin + batch.size()))
+            return false;
+    }
+    return true;
+}
+
+// Compact and replacing invalid UTF-8 instead of throwing, for one line of NDJSON
+[[nodiscard]] std::string DumpLine(ordered_json const& json) { return json.dump(-1, ' ', false, ordered_json::error_handler_t::replace); }
+
+}
@@ -1,13 +1,34 @@
 module;
-#include <Windows.h>
+#include <mio/mmap.hpp>
 
 export module GW2Viewer.Utils.ScanPE;
 import GW2Viewer.Common;
+import GW2Viewer.Utils.CRC;
 import std;
 
 export namespace GW2Viewer::Utils::ScanPE
 {
 
+struct FileKey
+{
+    uint64 Size = 0;
+    uint32 CRC = 0;
+
+    [[nodiscard]] explicit operator bool() const { return Size; }
+    [[nodiscard]] bool operator==(FileKey const&) const = default;
+};
+[[nodiscard]] FileKey GetFileKey(std::filesystem::path const& path)
+{
+    std::error_code error;
+    mio::mmap_source file;
+    file.map(path.native(), error);
+    if (error)
+        return { };
+    return { file.size(), CRC::Calculate(0, { (byte const*)file.data(), file.size() }) };
+}
+
+// Read-only view of a PE32+ image. Sections point straight into the file mapping, pointers stored inside the image are virtual addresses
+// relative to the preferred image base and have to be resolved through ResolveVA() before being dereferenced.
 struct Scanner
 {
     struct Section
@@ -15,7 +36,6 @@ struct Scanner
         std::span<byte const> Bounds { };
         uint32 VirtualAddress = 0;
         uint64 ImageBase = 0;
-        byte const* ModuleBase = nullptr;
 
         auto size() const { return Bounds.size(); }
         auto begin() const { return Bounds.data(); }
@@ -25,41 +45,86 @@ struct Scanner
 
         [[nodiscard]] bool Contains(void const* ptr) const { return ptr >= Bounds.data() && ptr <= Bounds.data() + Bounds.size(); }
         [[nodiscard]] bool Valid(void const* ptr) const { return !ptr || Contains(ptr); }
+        [[nodiscard]] bool ContainsRVA(uint64 rva) const { return rva >= VirtualAddress && rva - VirtualAddress < Bounds.size(); }
+        [[nodiscard]] bool ContainsVA(uint64 va) const { return va >= ImageBase && ContainsRVA(va - ImageBase); }
+        [[nodiscard]] bool ValidVA(uint64 va) const { return !va || ContainsVA(va); }
 
         [[nodiscard]] std::optional<uint64> GetSectionOffset(void const* ptr) const { if (Contains(ptr)) return std::distance(Bounds.data(), (byte const*)ptr); return { }; }
         [[nodiscard]] std::optional<uint64> GetRVA(void const* ptr) const { if (auto offset = GetSectionOffset(ptr)) return VirtualAddress + *offset; return { }; }
         [[nodiscard]] std::optional<uint64> GetVA(void const* ptr) const { if (auto rva = GetRVA(ptr)) return ImageBase + *rva; return { }; }
+
+        template<typename T = byte>
+        [[nodiscard]] T const* FromRVA(uint64 rva) const { return ContainsRVA(rva) ? (T const*)&Bounds[rva - VirtualAddress] : nullptr; }
+        template<typename T = byte>
+        [[nodiscard]] T const* FromVA(uint64 va) const { return ContainsVA(va) ? FromRVA<T>(va - ImageBase) : nullptr; }
     };
 
     std::span<byte const> File;
-    std::span<byte const> Module;
+    uint64 ImageBase = 0;
+    std::vector<Section> Sections;
     Section text, rdata, data;
 
     explicit Scanner(std::filesystem::path const& path)
     {
-        std::ifstream fileStream(path, std::ios::binary);
-        if (!fileStream.is_open())
+        std::error_code error;
+        m_file.map(path.native(), error);
+        if (error)
             return;
 
-        auto const fileSize = file_size(path);
-        std::unique_ptr<byte[]> const fileContents = std::make_unique<byte[]>(fileSize);
-        if (!fileStream.read((char*)fileContents.get(), fileSize))
-            return;
-
-        File = { fileContents.get(), fileSize };
+        File = { (byte const*)m_file.data(), m_file.size() };
 
-        auto const dos = (IMAGE_DOS_HEADER const*)&File[0];
-        auto const nt = (IMAGE_NT_HEADERS const*)&File[dos->e_lfanew];
-
-        byte* module = (byte*)VirtualAlloc(nullptr, nt->OptionalHeader.SizeOfImage, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
-        Module = { module, nt->OptionalHeader.SizeOfImage };
+#pragma pack(push, 1)
+        struct FileHeader
+        {
+            uint32 Signature;
+            uint16 Machine;
+            uint16 NumberOfSections;
+            uint32 TimeDateStamp;
+            uint32 PointerToSymbolTable;
+            uint32 NumberOfSymbols;
+            uint16 SizeOfOptionalHeader;
+            uint16 Characteristics;
+        };
+        struct OptionalHeader64
+        {
+            uint16 Magic;
+            byte Unused0[22];
+            uint64 ImageBase;
+        };
+        struct SectionHeader
+        {
+            char Name[8];
+            uint32 VirtualSize;
+            uint32 VirtualAddress;
+            uint32 SizeOfRawData;
+            uint32 PointerToRawData;
+            byte Unused0[16];
+        };
+#pragma pack(pop)
+        static_assert(sizeof(FileHeader) == 24);
+        static_assert(sizeof(SectionHeader) == 40);
+
+        if (File.size() < 0x40 || File[0] != 'M' || File[1] != 'Z')
+            return;
+        uint32 const ntOffset = *(uint32 const*)&File[0x3C];
+        if (File.size() < ntOffset + sizeof(FileHeader) + sizeof(OptionalHeader64))
+            return;
+        auto const& nt = *(FileHeader const*)&File[ntOffset];
+        auto const& optional = *(OptionalHeader64 const*)&File[ntOffset + sizeof(FileHeader)];
+        if (nt.Signature != std::byteswap('PE\0\0') || optional.Magic != 0x20B)
+            return;
 
-        std::fill_n(module, Module.size(), 0);
-        std::copy_n(&File[0], nt->OptionalHeader.SizeOfHeaders, module);
+        ImageBase = optional.ImageBase;
+        uint64 const sectionsOffset = ntOffset + sizeof(FileHeader) + nt.SizeOfOptionalHeader;
+        if (File.size() < sectionsOffset + nt.NumberOfSections * sizeof(SectionHeader))
+            return;
 
-        for (auto const& section : std::span(IMAGE_FIRST_SECTION(nt), nt->FileHeader.NumberOfSections))
+        for (auto const& header : std::span((SectionHeader const*)&File[sectionsOffset], nt.NumberOfSections))
         {
-            std::copy_n(&File[section.PointerToRawData], std::min(section.SizeOfRawData, section.Misc.VirtualSize), &module[section.VirtualAddress]);
+            if (header.PointerToRawData >= File.size())
+                continue;
+
+            auto& section = Sections.emplace_back(File.subspan(header.PointerToRawData, std::min<uint64>({ header.SizeOfRawData, header.VirtualSize ? header.VirtualSize : header.SizeOfRawData, File.size() - header.PointerToRawData })), header.VirtualAddress, ImageBase);
 
             static std::map<std::string_view, Section(Scanner::*)> contextSectionMapping
             {
@@ -67,40 +132,32 @@ struct Scanner
                 { ".rdata", &Scanner::rdata },
                 { ".data",  &Scanner::data  },
             };
-            if (auto const itr = contextSectionMapping.find((char const*)section.Name); itr != contextSectionMapping.end())
-            {
-                auto& target = this->*itr->second;
-                target.Bounds = { &module[section.VirtualAddress], section.SizeOfRawData };
-                target.VirtualAddress = section.VirtualAddress;
-                target.ImageBase = nt->OptionalHeader.ImageBase;
-                target.ModuleBase = Module.data();
-            }
+            if (auto const itr = contextSectionMapping.find(std::string_view(header.Name, std::ranges::find(header.Name, '\0'))); itr != contextSectionMapping.end())
+                this->*itr->second = section;
         }
+    }
 
-        if (auto const& relocationDirectory = nt->OptionalHeader.DataDirectory[IMAGE_DIRECTORY_ENTRY_BASERELOC]; relocationDirectory.VirtualAddress && relocationDirectory.Size)
-        {
-            auto p = &module[relocationDirectory.VirtualAddress];
-            auto end = p + relocationDirectory.Size;
-            while (p < end)
-            {
-                auto const* relocation = (IMAGE_BASE_RELOCATION const*)p;
-                if (!relocation->SizeOfBlock)
-                    break;
-
-                for (auto const entry : std::span((uint16*)&relocation[1], (relocation->SizeOfBlock - sizeof(IMAGE_BASE_RELOCATION)) / sizeof(uint16)))
-                    if (entry >> 12 == IMAGE_REL_BASED_DIR64)
-                        *(uint64*)&module[relocation->VirtualAddress + (entry & 0x0FFF)] += (uint64)module - nt->OptionalHeader.ImageBase;
-
-                p += relocation->SizeOfBlock;
-            }
-        }
+    [[nodiscard]] byte const* ResolveRVA(uint64 rva) const
+    {
+        for (auto const& section : Sections)
+            if (auto const ptr = section.FromRVA(rva))
+                return ptr;
+        return nullptr;
     }
-    ~Scanner()
+    template<typename T = byte>
+    [[nodiscard]] T const* ResolveVA(uint64 va) const { return va >= ImageBase ? (T const*)ResolveRVA(va - ImageBase) : nullptr; }
+
+    // Resolves a rip-relative 32-bit displacement, ptrToOffset must point into one of the sections
+    [[nodiscard]] byte const* GetTargetFromOffset32(byte const* ptrToOffset) const
     {
-        VirtualFree((void*)Module.data(), 0, MEM_RELEASE);
+        for (auto const& section : Sections)
+            if (auto const rva = section.GetRVA(ptrToOffset))
+                return ResolveRVA(*rva + sizeof(int32) + *(int32 const*)ptrToOffset);
+        return nullptr;
     }
 
-    [[nodiscard]] static byte const* GetTargetFromOffset32(byte const* ptrToOffset) { return ptrToOffset + sizeof(uint32) + *(uint32 const*)ptrToOffset; }
+private:
+    mio::mmap_source m_file;
 };
 
 }